@@ -1,7 +1,14 @@
 #include "GIC.h"
+#include "MPCore.h"
 
+#if CPUS > 1
+// on realview-pbx-a9, the GIC is part of the MPCore private memory region
+volatile GICC_t* GICC0 = ( volatile GICC_t* )( 0x1F000100 );
+volatile GICD_t* GICD0 = ( volatile GICD_t* )( 0x1F001000 );
+#else
 volatile GICC_t* GICC0 = ( volatile GICC_t* )( 0x1E000000 );
 volatile GICD_t* GICD0 = ( volatile GICD_t* )( 0x1E001000 );
+#endif
 volatile GICC_t* GICC1 = ( volatile GICC_t* )( 0x1E010000 );
 volatile GICD_t* GICD1 = ( volatile GICD_t* )( 0x1E011000 );
 volatile GICC_t* GICC2 = ( volatile GICC_t* )( 0x1E020000 );
@@ -21,4 +21,16 @@ void mmu_set_ptr1( uint32_t* x );
 // configure MMU: set 2-bit permission field of domain d to x
 void mmu_set_dom( int d, uint8_t x );
 
+//  enable data and instruction caches, plus branch predictor
+void mmu_enable_cache();
+// take part in cache coherency, and broadcast maintenance, between cores (Cortex-A9 only)
+void mmu_set_smp();
+
+// invalidate instruction cache and branch predictor
+void mmu_inv_icache();
+// invalidate L1 data cache (without cleaning it first)
+void mmu_inv_dcache();
+// clean data cache lines covering n bytes from x, st. instruction fetches see them
+void mmu_clean_dcache( void* x, size_t n );
+
 #endif
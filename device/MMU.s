@@ -24,9 +24,17 @@
 	
 .global mmu_set_dom
 
+.global mmu_enable_cache
+.global mmu_set_smp
+
+.global mmu_inv_icache
+.global mmu_inv_dcache
+.global mmu_clean_dcache
+
 mmu_enable:          mrc   p15, 0, r0, c1, c0, 0 @ read  SCTLR
                      orr   r0, r0, #0x1          @ set   SCTLR[ M ] = 1 => MMU  enable
                      mcr   p15, 0, r0, c1, c0, 0 @ write SCTLR
+                     isb                         @ synchronise context
 
                      mov   pc, lr                @ return
 
@@ -61,3 +69,63 @@ mmu_set_dom:         add   r0, r0, r0            @ compute i (index      from do
 
                      mov   pc, lr                @ return
 
+mmu_enable_cache:    mrc   p15, 0, r0, c1, c0, 0 @ read  SCTLR
+                     orr   r0, r0, #0x4          @ set   SCTLR[ C ] = 1 =>     data cache enable
+                     orr   r0, r0, #0x800        @ set   SCTLR[ Z ] = 1 => branch predictor enable
+                     orr   r0, r0, #0x1000       @ set   SCTLR[ I ] = 1 =>    instr. cache enable
+                     mcr   p15, 0, r0, c1, c0, 0 @ write SCTLR
+                     isb                         @ synchronise context
+
+                     mov   pc, lr                @ return
+
+mmu_set_smp:         mrc   p15, 0, r0, c1, c0, 1 @ read  ACTLR
+                     orr   r0, r0, #0x40         @ set   ACTLR[ SMP ] = 1 => take part in coherency (Cortex-A9)
+                     orr   r0, r0, #0x01         @ set   ACTLR[ FW  ] = 1 => broadcast cache and TLB maintenance
+                     mcr   p15, 0, r0, c1, c0, 1 @ write ACTLR
+
+                     mov   pc, lr                @ return
+
+mmu_inv_icache:      mov   r0,     #0x0
+                     mcr   p15, 0, r0, c7, c5, 0 @ write ICIALLU => invalidate instr. cache
+                     mcr   p15, 0, r0, c7, c5, 6 @ write BPIALL  => invalidate branch predictor
+                     dsb                         @ barrier: invalidation complete
+                     isb                         @ synchronise context
+
+                     mov   pc, lr                @ return
+
+mmu_inv_dcache:      push  { r4-r7 }
+                     mov   r0,     #0x0
+                     mcr   p15, 2, r0, c0, c0, 0 @ write CSSELR => select L1 data cache
+                     isb
+                     mrc   p15, 1, r0, c0, c0, 0 @ read  CCSIDR
+                     and   r1, r0, #0x7
+                     add   r1, r1, #4            @ compute log2( line size )
+                     ldr   r3, =0x3FF
+                     and   r3, r3, r0, lsr #3    @ compute ways - 1
+                     ldr   r2, =0x7FFF
+                     and   r2, r2, r0, lsr #13   @ compute sets - 1
+                     clz   r4, r3                @ compute way shift
+
+l2:                  mov   r5, r2                @ for each way ...
+l3:                  mov   r6, r3, lsl r4        @          ... and each set
+                     orr   r6, r6, r5, lsl r1
+                     mcr   p15, 0, r6, c7, c6, 2 @ write DCISW => invalidate line by set/way
+                     subs  r5, r5, #1
+                     bge   l3
+                     subs  r3, r3, #1
+                     bge   l2
+
+                     dsb                         @ barrier: invalidation complete
+                     pop   { r4-r7 }
+
+                     mov   pc, lr                @ return
+
+mmu_clean_dcache:    add   r1, r0, r1            @ compute limit = x + n
+                     bic   r0, r0, #0x1F         @ align x to (minimum) line size of 32 bytes
+l4:                  mcr   p15, 0, r0, c7, c11, 1 @ write DCCMVAU => clean line to PoU
+                     add   r0, r0, #0x20
+                     cmp   r0, r1
+                     blo   l4
+                     dsb                         @ barrier: clean complete
+
+                     mov   pc, lr                @ return
@@ -0,0 +1,4 @@
+#include "MPCore.h"
+
+volatile SCU_t*    SCU0    = ( volatile SCU_t*    )( 0x1F000000 );
+volatile PTIMER_t* PTIMER0 = ( volatile PTIMER_t* )( 0x1F000600 );
@@ -0,0 +1,58 @@
+#ifndef __MPCORE_H
+#define __MPCORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* The number of cores is fixed at build time: the default of 1 targets
+ * the (single-core) realview-pb-a8 platform, whereas anything greater,
+ * e.g., -DCPUS=4, targets the Cortex-A9 MPCore based realview-pbx-a9.
+ */
+
+#ifndef CPUS
+#define CPUS 1
+#endif
+
+// image.ld, and the per-core stack offsets in lolevel.s, allow for 4 cores
+#if CPUS > 4
+#error "at most 4 cores are supported"
+#endif
+
+/* The Cortex-A9 MPCore private memory region is documented at
+ *
+ * http://infocenter.arm.com/help/topic/com.arm.doc.ddi0407i/index.html
+ *
+ * In particular, Section 2.2 describes the Snoop Control Unit (SCU), and
+ * Section 4.2 describes the private timer: each core has its own timer,
+ * banked at the same address, which raises private interrupt ID 29.
+ */
+
+typedef volatile struct {
+  uint32_t CTRL;             // 0x0000          : control
+  uint32_t CONFIG;           // 0x0004          : configuration
+  uint32_t CPUSTATUS;        // 0x0008          : CPU power status
+  uint32_t INVALL;           // 0x000C          : invalidate all
+} SCU_t;
+
+typedef volatile struct {
+  uint32_t Load;             // 0x0000          :            load
+  uint32_t Counter;          // 0x0004          : current value
+  uint32_t Ctrl;             // 0x0008          : control
+  uint32_t IntClr;           // 0x000C          : interrupt status (write 1 to clear)
+} PTIMER_t;
+
+#define GIC_SOURCE_PTIMER ( 29 )
+
+/* Per Table 4.2 of
+ *
+ * http://infocenter.arm.com/help/topic/com.arm.doc.dui0440b/index.html
+ *
+ * the private memory region of realview-pbx-a9 is based at 0x1F000000,
+ * so we can just define a (structured) pointer to each device in it.
+ */
+
+extern volatile SCU_t*    SCU0;
+extern volatile PTIMER_t* PTIMER0;
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef __PMU_H
+#define __PMU_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* The Cortex-A8 Performance Monitor Unit (PMU) offers 4 configurable
+ * event counters plus a dedicated cycle counter; the event numbers
+ * below are taken from Table 3-140 of
+ *
+ * http://infocenter.arm.com/help/topic/com.arm.doc.ddi0344k/index.html
+ *
+ * Note that the cycle counter is identified by bit 31 in the enable
+ * registers, so the same index is used to identify it here.
+ */
+
+#define PMU_COUNTERS          (    4 )
+#define PMU_CYCLE_COUNTER     (   31 )
+
+#define PMU_EVENT_L1I_REFILL  ( 0x01 ) // instruction cache miss
+#define PMU_EVENT_L1D_REFILL  ( 0x03 ) //        data cache miss
+#define PMU_EVENT_INSTR       ( 0x08 ) // instructions architecturally executed
+#define PMU_EVENT_BR_MISPRED  ( 0x10 ) // branch mispredicted or not predicted
+#define PMU_EVENT_CYCLES      ( 0xFF ) // cycles (via the cycle counter)
+
+//  enable PMU, resetting all counters
+void     pmu_enable();
+// disable PMU
+void     pmu_unable();
+
+//  enable counters whose bit is set in mask x
+void     pmu_set_cnt_on( uint32_t x );
+// disable counters whose bit is set in mask x
+void     pmu_set_cnt_off( uint32_t x );
+
+// configure event counter i to count event x
+void     pmu_set_evt( int i, uint32_t x );
+// write value x into event counter i
+void     pmu_set_cnt( int i, uint32_t x );
+// read  value   from event counter i
+uint32_t pmu_get_cnt( int i );
+
+// write value x into cycle counter
+void     pmu_set_ccnt( uint32_t x );
+// read  value   from cycle counter
+uint32_t pmu_get_ccnt();
+
+#endif
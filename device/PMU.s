@@ -0,0 +1,66 @@
+@ Section C12 of
+@
+@ http://infocenter.arm.com/help/index.jsp?topic=/com.arm.doc.ddi0406c/index.html
+@
+@ describes the Performance Monitors extension, which is controlled
+@ via co-processor 15 using CRn = c9.  As with the MMU, the following
+@ functions wrap the mcr and mrc instructions required into a simple
+@ API: event counters are accessed indirectly, by first writing the
+@ counter index into PMSELR then reading or writing PMXEVTYPER or
+@ PMXEVCNTR, whereas the cycle counter has its own register PMCCNTR.
+
+.global pmu_enable
+.global pmu_unable
+
+.global pmu_set_cnt_on
+.global pmu_set_cnt_off
+
+.global pmu_set_evt
+.global pmu_set_cnt
+.global pmu_get_cnt
+
+.global pmu_set_ccnt
+.global pmu_get_ccnt
+
+pmu_enable:          mrc   p15, 0, r0, c9, c12, 0 @ read  PMCR
+                     orr   r0, r0, #0x7           @ set   PMCR[ C, P, E ] = 1 => reset counters, enable
+                     mcr   p15, 0, r0, c9, c12, 0 @ write PMCR
+
+                     mov   pc, lr                 @ return
+
+pmu_unable:          mrc   p15, 0, r0, c9, c12, 0 @ read  PMCR
+                     bic   r0, r0, #0x1           @ set   PMCR[ E ] = 0 => disable
+                     mcr   p15, 0, r0, c9, c12, 0 @ write PMCR
+
+                     mov   pc, lr                 @ return
+
+pmu_set_cnt_on:      mcr   p15, 0, r0, c9, c12, 1 @ write PMCNTENSET
+
+                     mov   pc, lr                 @ return
+
+pmu_set_cnt_off:     mcr   p15, 0, r0, c9, c12, 2 @ write PMCNTENCLR
+
+                     mov   pc, lr                 @ return
+
+pmu_set_evt:         mcr   p15, 0, r0, c9, c12, 5 @ write PMSELR
+                     mcr   p15, 0, r1, c9, c13, 1 @ write PMXEVTYPER
+
+                     mov   pc, lr                 @ return
+
+pmu_set_cnt:         mcr   p15, 0, r0, c9, c12, 5 @ write PMSELR
+                     mcr   p15, 0, r1, c9, c13, 2 @ write PMXEVCNTR
+
+                     mov   pc, lr                 @ return
+
+pmu_get_cnt:         mcr   p15, 0, r0, c9, c12, 5 @ write PMSELR
+                     mrc   p15, 0, r0, c9, c13, 2 @ read  PMXEVCNTR
+
+                     mov   pc, lr                 @ return
+
+pmu_set_ccnt:        mcr   p15, 0, r0, c9, c13, 0 @ write PMCCNTR
+
+                     mov   pc, lr                 @ return
+
+pmu_get_ccnt:        mrc   p15, 0, r0, c9, c13, 0 @ read  PMCCNTR
+
+                     mov   pc, lr                 @ return
@@ -0,0 +1,30 @@
+#ifndef __VFP_H
+#define __VFP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* The VFP and NEON extensions share one register file, i.e., the 32
+ * 64-bit registers d0 to d31 plus FPSCR; any use of it while disabled
+ * (via FPEXC) raises an undefined instruction exception.
+ */
+
+#define VFP_WORDS ( 65 )              // d0 to d31, plus FPSCR
+
+// allow access to the VFP (i.e., co-processors 10 and 11), but disabled
+void     vfp_init();
+
+//  enable VFP
+void     vfp_enable();
+// disable VFP
+void     vfp_unable();
+// check whether VFP is enabled
+bool     vfp_enabled();
+
+// save    register file into x
+void     vfp_save( uint32_t* x );
+// restore register file from x
+void     vfp_restore( const uint32_t* x );
+
+#endif
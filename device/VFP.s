@@ -0,0 +1,59 @@
+@ Section B1.11 of
+@
+@ http://infocenter.arm.com/help/index.jsp?topic=/com.arm.doc.ddi0406c/index.html
+@
+@ describes how the VFP and NEON extensions are enabled: CPACR (via
+@ co-processor 15) grants access to co-processors 10 and 11, then the
+@ EN bit of FPEXC enables or disables the extensions as a whole.  The
+@ following functions wrap the instructions required into a simple API.
+
+.fpu neon
+
+.global vfp_init
+
+.global vfp_enable
+.global vfp_unable
+.global vfp_enabled
+
+.global vfp_save
+.global vfp_restore
+
+vfp_init:            mrc   p15, 0, r0, c1, c0, 2  @ read  CPACR
+                     orr   r0, r0, #0x00F00000    @ set   CPACR[ cp10, cp11 ] = 3 => full access
+                     mcr   p15, 0, r0, c1, c0, 2  @ write CPACR
+                     isb                          @ synchronise context
+
+                     mov   r0, #0
+                     vmsr  fpexc, r0              @ write FPEXC[ EN ] = 0 => disable
+
+                     mov   pc, lr                 @ return
+
+vfp_enable:          mov   r0, #0x40000000
+                     vmsr  fpexc, r0              @ write FPEXC[ EN ] = 1 =>  enable
+
+                     mov   pc, lr                 @ return
+
+vfp_unable:          mov   r0, #0
+                     vmsr  fpexc, r0              @ write FPEXC[ EN ] = 0 => disable
+
+                     mov   pc, lr                 @ return
+
+vfp_enabled:         vmrs  r0, fpexc              @ read  FPEXC
+                     lsr   r0, r0, #30            @ extract FPEXC[ EN ]
+                     and   r0, r0, #0x1
+
+                     mov   pc, lr                 @ return
+
+vfp_save:            vstmia r0!, { d0-d15 }       @ store d0  to d15
+                     vstmia r0!, { d16-d31 }      @ store d16 to d31
+                     vmrs  r1, fpscr              @ read  FPSCR
+                     str   r1, [ r0 ]             @ store FPSCR
+
+                     mov   pc, lr                 @ return
+
+vfp_restore:         vldmia r0!, { d0-d15 }       @ load  d0  to d15
+                     vldmia r0!, { d16-d31 }      @ load  d16 to d31
+                     ldr   r1, [ r0 ]             @ load  FPSCR
+                     vmsr  fpscr, r1              @ write FPSCR
+
+                     mov   pc, lr                 @ return
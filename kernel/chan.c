@@ -0,0 +1,127 @@
+#include "chan.h"
+
+chan_t chans[CHAN_NUM];
+
+chan_t *chan_get(int id) {
+  if (id < 0 || id >= CHAN_NUM || !chans[id].open) {
+    return NULL;
+  }
+
+  return &chans[id];
+}
+
+chan_sub_t *chan_find(chan_t *chan, pid_t pid) {
+  for (int i = 0; i < CHAN_SUBS; i++) {
+    if (chan->subs[i].pid == pid) {
+      return &chan->subs[i];
+    }
+  }
+
+  return NULL;
+}
+
+int chan_open() {
+  for (int i = 0; i < CHAN_NUM; i++) {
+    if (!chans[i].open) {
+      memset(&chans[i], 0, sizeof(chan_t));
+      chans[i].open = true;
+
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+int chan_close(int id) {
+  chan_t *chan = chan_get(id);
+
+  if (chan == NULL) {
+    return -1;
+  }
+
+  chan->open = false;
+  return 0;
+}
+
+int chan_subscribe(pid_t pid, int id) {
+  chan_t *chan = chan_get(id);
+
+  if (chan == NULL || chan_find(chan, pid) != NULL) {
+    return -1;
+  }
+
+  chan_sub_t *sub = chan_find(chan, 0);
+
+  if (sub == NULL) {
+    return -1;
+  }
+
+  sub->pid    = pid;
+  sub->cursor = chan->seq;
+
+  return 0;
+}
+
+int chan_publish(int id, int x) {
+  chan_t *chan = chan_get(id);
+
+  if (chan == NULL) {
+    return -1;
+  }
+
+  chan->buf[chan->seq % CHAN_SLOTS] = x;
+  chan->seq++;
+
+  // report, rather than wait for, subscribers whose oldest message was
+  // just overwritten
+  int slow = 0;
+
+  for (int i = 0; i < CHAN_SUBS; i++) {
+    if (chan->subs[i].pid != 0 && chan->seq - chan->subs[i].cursor > CHAN_SLOTS) {
+      slow++;
+    }
+  }
+
+  return slow;
+}
+
+int chan_read(pid_t pid, int id, int *x) {
+  chan_t *chan = chan_get(id);
+  chan_sub_t *sub = (chan == NULL) ? NULL : chan_find(chan, pid);
+
+  if (sub == NULL) {
+    return -1;
+  }
+
+  if (sub->cursor == chan->seq) {
+    return CHAN_AGAIN;
+  }
+
+  // skip to the oldest message still held
+  int lost = 0;
+
+  if (chan->seq - sub->cursor > CHAN_SLOTS) {
+    lost        = chan->seq - sub->cursor - CHAN_SLOTS;
+    sub->cursor = chan->seq - CHAN_SLOTS;
+  }
+
+  *x = chan->buf[sub->cursor % CHAN_SLOTS];
+  sub->cursor++;
+
+  return lost;
+}
+
+uint32_t chan_addr(int id) {
+  return (uint32_t) &chans[id].seq;
+}
+
+void chan_exit(pid_t pid) {
+  for (int i = 0; i < CHAN_NUM; i++) {
+    chan_sub_t *sub = chans[i].open ? chan_find(&chans[i], pid) : NULL;
+
+    if (sub != NULL) {
+      sub->pid = 0;
+    }
+  }
+}
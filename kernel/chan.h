@@ -0,0 +1,56 @@
+#ifndef __CHAN_H
+#define __CHAN_H
+
+#include "hilevel.h"
+
+/* A channel broadcasts int messages from any publisher to every process
+ * subscribed to it: each message is written once into a ring buffer of
+ * CHAN_SLOTS slots, tagged by a sequence number, and each subscriber
+ * reads at its own cursor (starting at the next message published after
+ * it subscribed).  The publisher never waits for subscribers, so one
+ * which falls more than CHAN_SLOTS messages behind loses the oldest: the
+ * publisher is told how many subscribers just lost a message, and each
+ * such subscriber how many it lost when it next reads.
+ */
+
+#define CHAN_NUM    8
+#define CHAN_SLOTS 32
+#define CHAN_SUBS   8
+
+#define CHAN_AGAIN  ( -2 )          // nothing to read yet
+
+typedef struct {
+  pid_t    pid;                     // subscriber (0 => unused)
+  uint32_t cursor;                  // sequence number of next message to read
+} chan_sub_t;
+
+typedef struct {
+  bool       open;
+  uint32_t   seq;                   // sequence number of next message published
+  int        buf[ CHAN_SLOTS ];
+  chan_sub_t subs[ CHAN_SUBS ];
+} chan_t;
+
+// Open a channel; return its id, or -1.
+int  chan_open();
+
+// Close a channel, dropping every subscriber; return 0, or -1 if no such channel.
+int  chan_close(int id);
+
+// Subscribe the process to the channel; return 0, or -1.
+int  chan_subscribe(pid_t pid, int id);
+
+// Publish x on the channel; return how many subscribers lost a message, or -1.
+int  chan_publish(int id, int x);
+
+// Read the next message for the process into x; return how many messages it
+// lost since its last read, CHAN_AGAIN if there is none yet, or -1.
+int  chan_read(pid_t pid, int id, int *x);
+
+// Return the address processes waiting on the channel block on.
+uint32_t chan_addr(int id);
+
+// Drop the process from every channel it is subscribed to.
+void chan_exit(pid_t pid);
+
+#endif
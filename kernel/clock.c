@@ -0,0 +1,51 @@
+#include "clock.h"
+
+// placed on its own page by image.ld
+extern clock_page_t clock_page;
+
+void clock_init() {
+  TIMER0->Timer2Load  = 0xFFFFFFFF; // select maximum period
+  TIMER0->Timer2Ctrl  = 0x00000002; // select 32-bit       timer
+  TIMER0->Timer2Ctrl |= 0x00000080; // enable free-running timer
+
+  clock_page.seq     = 0;
+  clock_page.hz      = CLOCK_HZ;
+  clock_page.counter = &TIMER0->Timer2Value;
+  clock_page.wraps   = 0;
+  clock_page.last    = ~TIMER0->Timer2Value;
+}
+
+void clock_tick() {
+  uint32_t now = ~TIMER0->Timer2Value;
+
+  clock_page.seq++;
+  __sync_synchronize();
+
+  if (now < clock_page.last) {
+    clock_page.wraps++;
+  }
+  clock_page.last = now;
+
+  __sync_synchronize();
+  clock_page.seq++;
+}
+
+// the timer tick is on core 0, so a reader on another core may race it
+uint64_t clock_read() {
+  uint32_t seq, wraps, last, now;
+
+  do {
+    seq   = clock_page.seq;
+    __sync_synchronize();
+    wraps = clock_page.wraps;
+    last  = clock_page.last;
+    now   = ~*clock_page.counter;
+    __sync_synchronize();
+  } while ((seq & 1) || seq != clock_page.seq);
+
+  if (now < last) {
+    wraps++;
+  }
+
+  return ((uint64_t) wraps << 32) | now;
+}
@@ -0,0 +1,37 @@
+#ifndef __CLOCK_H
+#define __CLOCK_H
+
+#include "hilevel.h"
+
+/* The monotonic clock is the free-running (32-bit, down-counting) timer
+ * #1 of TIMER0, extended to 64 bits by counting its wraps: the kernel
+ * publishes the count of wraps, plus the value it last saw, in a page
+ * every process can read, st. a read needs no system call.  A reader
+ * extends the (inverted, i.e., counting up) counter by the wraps, plus
+ * one if it has since wrapped again, which the timer tick guarantees it
+ * has done at most once.  The kernel makes seq odd while it updates the
+ * page, so a reader retries unless seq is even and unchanged across its
+ * read.  The layout must match libc.h.
+ */
+
+#define CLOCK_HZ        1000000     // counter ticks per second (i.e., 1MHz)
+#define CLOCK_MONOTONIC 1
+
+typedef struct {
+  uint32_t           seq;           // odd iff. the page is being updated
+  uint32_t           hz;            // counter ticks per second
+  volatile uint32_t *counter;       // address of the down-counting counter
+  uint32_t           wraps;         // wraps of the counter up to last
+  uint32_t           last;          // (inverted) counter value at last update
+} clock_page_t;
+
+// Start the free-running counter, and initialise the clock page.
+void clock_init();
+
+// Bring the clock page up to date; must happen at least once per wrap.
+void clock_tick();
+
+// Return the number of counter ticks since reset.
+uint64_t clock_read();
+
+#endif
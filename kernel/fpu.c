@@ -0,0 +1,80 @@
+#include "fpu.h"
+
+pcb_t *fpu_owner[ CPUS ];
+
+// the state of a process which has yet to use the VFP
+const uint32_t fpu_zero[ VFP_WORDS ];
+
+void fpu_init() {
+  vfp_init();
+
+  fpu_owner[cpu_id()] = NULL;
+}
+
+void fpu_dispatch(pcb_t *prev, pcb_t *next) {
+  pcb_t **owner = &fpu_owner[cpu_id()];
+
+#if CPUS > 1
+  // prev may run on another core next, so its state cannot stay behind
+  if (*owner == prev && prev != next) {
+    vfp_save(prev->fpu);
+    *owner = NULL;
+  }
+#else
+  // with one core, prev's state can stay behind until it runs again
+  (void) prev;
+#endif
+
+  if (*owner == next) {
+    vfp_enable();
+  }
+  else {
+    vfp_unable();
+  }
+}
+
+bool fpu_trap(pcb_t *pcb) {
+  pcb_t **owner = &fpu_owner[cpu_id()];
+
+  if (vfp_enabled()) {
+    return false;
+  }
+
+  vfp_enable();
+
+  if (*owner != NULL) {
+    vfp_save((*owner)->fpu);
+  }
+
+  vfp_restore(pcb->fpu_used ? pcb->fpu : fpu_zero);
+
+  pcb->fpu_used = true;
+  *owner        = pcb;
+
+  return true;
+}
+
+void fpu_fork(pcb_t *child, pcb_t *parent) {
+  // bring the saved state of the parent up to date, if it is live
+  if (fpu_owner[cpu_id()] == parent) {
+    vfp_save(parent->fpu);
+  }
+
+  memcpy(child->fpu, parent->fpu, sizeof(child->fpu));
+  child->fpu_used = parent->fpu_used;
+}
+
+void fpu_exit(pcb_t *pcb) {
+  for (int i = 0; i < CPUS; i++) {
+    if (fpu_owner[i] == pcb) {
+      fpu_owner[i] = NULL;
+
+      // the process may keep running, e.g., after exec, so must trap anew
+      if (i == cpu_id()) {
+        vfp_unable();
+      }
+    }
+  }
+
+  pcb->fpu_used = false;
+}
@@ -0,0 +1,32 @@
+#ifndef __FPU_H
+#define __FPU_H
+
+#include "hilevel.h"
+
+/* The VFP register file is switched lazily: each core leaves it holding
+ * the state of the last process to use it (its owner), but disables it
+ * whenever a different process is dispatched.  The first VFP or NEON
+ * instruction that process executes then traps, at which point the owner's
+ * state is saved into its pcb and the new process's state restored,
+ * st. a process which never uses the VFP never pays to switch it.  On a
+ * multi-core system a process may migrate between cores, so the state is
+ * instead saved whenever its owner is switched out (restores stay lazy).
+ */
+
+// Initialise the VFP of the calling core, with no owner.
+void fpu_init();
+
+// Enable the VFP iff. the next process owns it, having switched from prev.
+void fpu_dispatch(pcb_t *prev, pcb_t *next);
+
+// Handle a trap caused by the current process using the disabled VFP, making
+// it the owner; return false iff. the VFP was enabled, i.e., the trap was not.
+bool fpu_trap(pcb_t *pcb);
+
+// Give the child a copy of the parent's VFP state.
+void fpu_fork(pcb_t *child, pcb_t *parent);
+
+// Discard the VFP state of a process, e.g., as it exits.
+void fpu_exit(pcb_t *pcb);
+
+#endif
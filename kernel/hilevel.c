@@ -11,26 +11,26 @@
 
 Ring *pipe_ring;
 Ring *pcb_ring;
+Ring *zombie_ring;
 
 // entry points for programs
 extern void main_console();
-
-// location of top of stack for user programs
-extern uint32_t tos_user_progs;
+extern void main_idle();
 
 pipe_t *create_pipe(pid_t pid1, pid_t pid2, int value, status_t status) {
-  pipe_t *new_pipe = malloc(sizeof(pipe_t));
+  pid_t pipe_id    = get_max_pipe_id(pipe_ring) + 1;
+  pipe_t *new_pipe = kmalloc(sizeof(pipe_t), KMEM_PIPE, pipe_id);
   new_pipe->proc1  = pid1;
   new_pipe->proc2  = pid2;
   new_pipe->value  = value;
-  new_pipe->pid    = get_max_pipe_id(pipe_ring) + 1;
+  new_pipe->pid    = pipe_id;
   new_pipe->status = status;
 
   return new_pipe;
 }
 
 ctx_t *create_ctx(uint32_t cpsr, uint32_t pc, uint32_t sp) {
-  ctx_t *new_ctx = malloc(sizeof(ctx_t));
+  ctx_t *new_ctx = kmalloc(sizeof(ctx_t), KMEM_CTX, 0);
   new_ctx->cpsr = cpsr;
   new_ctx->pc   = pc;
   new_ctx->sp   = sp;
@@ -39,7 +39,7 @@ ctx_t *create_ctx(uint32_t cpsr, uint32_t pc, uint32_t sp) {
 }
 
 pcb_t *create_pcb(pid_t pid, int priority, ctx_t *ctx) {
-  pcb_t *new_pcb = malloc(sizeof(pcb_t));
+  pcb_t *new_pcb = kmalloc(sizeof(pcb_t), KMEM_PCB, pid);
 
   new_pcb->pid      = pid;
   new_pcb->priority = priority;
@@ -47,186 +47,1137 @@ pcb_t *create_pcb(pid_t pid, int priority, ctx_t *ctx) {
 
   memcpy(&new_pcb->ctx, ctx, sizeof(ctx_t));
 
+  // no performance counters are open until requested
+  memset(&new_pcb->pmu, 0, sizeof(pmu_ctx_t));
+
+  new_pcb->runnable_at = stats_now();
+
+  new_pcb->stack_tos      = 0;
+  new_pcb->stack_size     = 0;
+  new_pcb->stack_overflow = false;
+
+  new_pcb->level = 0;
+  new_pcb->ticks = 0;
+
+  memset(&new_pcb->rt, 0, sizeof(rt_t));
+  new_pcb->group     = 0;
+  new_pcb->throttled = false;
+
+  new_pcb->cpu     = cpu_id();
+  new_pcb->running = false;
+  new_pcb->wait    = 0;
+
+  new_pcb->shm = 0;
+
+  new_pcb->poll       = 0;
+  new_pcb->poll_left  = 0;
+  new_pcb->poll_again = false;
+
+  // a process is the only thread in its own thread group
+  new_pcb->tgid   = pid;
+  new_pcb->ppid   = 0;
+  new_pcb->status = 0;
+  new_pcb->killed = false;
+
+  new_pcb->uring = NULL;
+
+  new_pcb->holder             = 0;
+  new_pcb->inherited_priority = INT_MIN;
+  new_pcb->inherited_level    = MLFQ_LEVELS;
+
+  // the VFP state is zeroed on first use
+  new_pcb->fpu_used = false;
+
+  memset(new_pcb->outbuf, 0, sizeof(new_pcb->outbuf));
+
   return new_pcb;
 }
 
-// switch processes according to priority queue
-void scheduler(ctx_t *ctx) {
-  age_processes(pcb_ring);
 
-  memcpy(&get_current_process(pcb_ring)->ctx,
-         ctx,
-         sizeof(ctx_t));
+// the next unused pid, including those of exited threads not yet joined
+pid_t next_pid() {
+  pid_t max_pid = get_max_pid(pcb_ring);
 
-  locate_highest_priority(pcb_ring);
+  if (!is_sentinel(zombie_ring->first->next) && get_max_pid(zombie_ring) > max_pid) {
+    max_pid = get_max_pid(zombie_ring);
+  }
 
-  memcpy(ctx,
-         &get_current_process(pcb_ring)->ctx,
-         sizeof(ctx_t));
+  return max_pid + 1;
+}
+
+
+// save the live performance counters of a process into its pcb
+void pmu_save(pcb_t *pcb) {
+  if (pcb->pmu.mask == 0) {
+    return;
+  }
+
+  pmu_set_cnt_off(pcb->pmu.mask);
+
+  for (int i = 0; i < PMU_COUNTERS; i++) {
+    if (pcb->pmu.mask & (1 << i)) {
+      pcb->pmu.count[i] = pmu_get_cnt(i);
+    }
+  }
+
+  if (pcb->pmu.mask & (1U << PMU_CYCLE_COUNTER)) {
+    pcb->pmu.ccnt = pmu_get_ccnt();
+  }
+}
+
+// load the saved performance counters of a process into the PMU
+void pmu_restore(pcb_t *pcb) {
+  // stop counting on behalf of whichever process ran previously
+  pmu_set_cnt_off(0xFFFFFFFF);
+
+  if (pcb->pmu.mask == 0) {
+    return;
+  }
+
+  for (int i = 0; i < PMU_COUNTERS; i++) {
+    if (pcb->pmu.mask & (1 << i)) {
+      pmu_set_evt(i, pcb->pmu.event[i]);
+      pmu_set_cnt(i, pcb->pmu.count[i]);
+    }
+  }
+
+  if (pcb->pmu.mask & (1U << PMU_CYCLE_COUNTER)) {
+    pmu_set_ccnt(pcb->pmu.ccnt);
+  }
+
+  pmu_set_cnt_on(pcb->pmu.mask);
+}
+
+// find the counter of a process counting the given event, or -1
+int pmu_find(pcb_t *pcb, uint32_t event) {
+  if (event == PMU_EVENT_CYCLES) {
+    return (pcb->pmu.mask & (1U << PMU_CYCLE_COUNTER)) ? PMU_CYCLE_COUNTER : -1;
+  }
+
+  for (int i = 0; i < PMU_COUNTERS; i++) {
+    if ((pcb->pmu.mask & (1 << i)) && pcb->pmu.event[i] == event) {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+// report a stack overflow on the kernel UART
+void stack_warn(pcb_t *pcb) {
+  char *x = "\nstack overflow: pid ";
+
+  while (*x != '\x00') {
+    PL011_putc(UART0, *x++, true);
+  }
+
+  PL011_puth(UART0, pcb->pid, true);
+  PL011_putc(UART0, '\n', true);
+}
+
+// load the context of the (new) current process, having switched from prev
+void dispatch(ctx_t *ctx, pcb_t *prev) {
+  pcb_t *next = get_current_process(pcb_ring);
+
+  // the previous process stays runnable, so time how long it waits
+  if (next != prev) {
+    uint32_t now = stats_now();
+    prev->runnable_at = now;
+    stats_dispatch(now - next->runnable_at);
+
+    prev->running = false;
+    next->running = true;
+  }
+
+  // a blocked process is only dispatched if nothing else is runnable, in
+  // which case it wakes up spuriously
+  if (next->wait != 0) {
+    // a poller keeps what is left of its timeout, to resume on retrying
+    next->poll_again = (next->poll != 0);
+    next->wait = 0;
+    next->poll = 0;
+    sched_throttle(next);
+  }
+
+  ctx_copy(ctx, &next->ctx);
+  pmu_restore(next);
+  fpu_dispatch(prev, next);
+  smp_set_tls(next->pid);
+}
+
+// wake up to n processes blocked on the address, in ring order; return how many
+int wake( uint32_t x, int n ) {
+  int r = 0;
+
+  for( Node *node = pcb_ring->first->next; !is_sentinel( node ) && r < n; node = node->next ) {
+    pcb_t *pcb = ( pcb_t* )( node->item );
+
+    if( pcb->wait == x ) {
+      pcb->wait = 0;
+      sched_throttle( pcb );
+      r++;
+
+      if( pcb->cpu != cpu_id() ) {
+        smp_kick( pcb->cpu );
+      }
+    }
+  }
+
+  return r;
+}
+
+// close the pipes of an exited process once neither end remains, rather
+// than leaving them for the leak check to find
+void pipe_exit(pid_t pid) {
+  bool closed = false;
+  Node *node  = pipe_ring->first->next;
+
+  while (!is_sentinel(node)) {
+    pipe_t *pipe = (pipe_t *) node->item;
+    node = node->next;
+
+    if ((pipe->proc1 == pid || pipe->proc2 == pid) &&
+        get_process_by_id(pcb_ring, pipe->proc1) == NULL &&
+        get_process_by_id(pcb_ring, pipe->proc2) == NULL) {
+      locate_by_pipe_id(pipe_ring, pipe->pid);
+      delete(pipe_ring);
+      kfree(pipe);
+      closed = true;
+    }
+  }
+
+  if (closed) {
+    poll_wake(false);
+  }
+}
+
+// release everything held by an exited process, which is no longer in the
+// ring, then keep its pcb as a zombie until the parent (or, for a thread,
+// the thread group) collects its status, or free it if nothing can
+void reclaim(pcb_t *pcb) {
+  outbuf_exit(pcb);
+  stack_free(pcb->stack_tos, pcb->stack_size);
+  shm_exit(pcb);
+  chan_exit(pcb->pid);
+  pipe_exit(pcb->pid);
+  fpu_exit(pcb);
+
+  bool   thread = pcb->tgid != pcb->pid;
+  pcb_t *reaper = get_process_by_id(pcb_ring, thread ? pcb->tgid : pcb->ppid);
+
+  // nothing can collect the status of the exited children (or threads) of
+  // an exited process, and its live children are orphaned
+  while (locate_by_ppid(zombie_ring, pcb->pid) || (!thread && locate_by_tgid(zombie_ring, pcb->pid))) {
+    pcb_t *zombie = get_current_process(zombie_ring);
+    delete(zombie_ring);
+    kfree(zombie);
+  }
+
+  for (Node *node = pcb_ring->first->next; !is_sentinel(node); node = node->next) {
+    if (((pcb_t *) node->item)->ppid == pcb->pid) {
+      ((pcb_t *) node->item)->ppid = 0;
+    }
+  }
+
+  if (reaper == NULL) {
+    kfree(pcb);
+    return;
+  }
+
+  insert_after(zombie_ring, pcb);
+  wake(thread ? (uint32_t) pcb : (uint32_t) reaper, MAX_PROGS);
+}
+
+// remove the current process from the ring with the given status, then
+// switch to the next process
+void terminate(ctx_t *ctx, int status) {
+  pcb_t *pcb = get_current_process(pcb_ring);
+  pcb->status = status;
+
+  // pick the next process while the exiting one is still current: as it
+  // is killed, it is not eligible, so (at worst) the idle process is
+  pcb->killed = true;
+  sched_next(SCHED_YIELD);
+
+  pid_t next_pid = get_current_pid(pcb_ring);
+
+  locate_by_id(pcb_ring, pcb->pid);
+  delete(pcb_ring);
+  locate_by_id(pcb_ring, next_pid);
+
+  dispatch(ctx, pcb);
+  reclaim(pcb);
+}
+
+// switch processes according to the scheduling policy: why is one of
+// SCHED_TICK, SCHED_YIELD or SCHED_WAKE, i.e., what invoked it
+void scheduler(ctx_t *ctx, int why) {
+  pcb_t *prev = get_current_process(pcb_ring);
+
+  // a process killed while running on this core is terminated on its way out
+  if (prev->killed) {
+    terminate(ctx, prev->status);
+    return;
+  }
+
+  ctx_copy(&prev->ctx, ctx);
+  pmu_save(prev);
+
+  // the guard word at the base of the stack is gone iff. it overflowed
+  if (!prev->stack_overflow && !stack_check(prev->stack_tos, prev->stack_size)) {
+    prev->stack_overflow = true;
+    stack_warn(prev);
+  }
+
+  sched_next(why);
+  dispatch(ctx, prev);
 }
 
 
 // create new child process identical to parent
 void hilevel_fork(ctx_t *ctx) {
-  pcb_t *child_pcb = create_pcb(get_max_pid(pcb_ring) + 1, ctx->gpr[0], ctx);
+  pcb_t *parent_pcb = get_current_process(pcb_ring);
+
+  // allocate a stack for the child the same size as the parent's
+  uint32_t new_tos = stack_alloc(parent_pcb->stack_size);
+
+  if (new_tos == 0) {
+    ctx->gpr[0] = -1;
+    return;
+  }
+
+  pcb_t *child_pcb = create_pcb(next_pid(), ctx->gpr[0], ctx);
+  child_pcb->stack_tos  = new_tos;
+  child_pcb->stack_size = parent_pcb->stack_size;
+  child_pcb->group      = parent_pcb->group;
+  child_pcb->cpu        = smp_place();
+  child_pcb->ppid       = parent_pcb->pid;
+
+  shm_fork(child_pcb, parent_pcb);
+  fpu_fork(child_pcb, parent_pcb);
+
+  // insert new child pcb into ring after current pcb
+  insert_after(pcb_ring, child_pcb);
+
+  // find top of stack for current program
+  uint32_t current_tos = parent_pcb->stack_tos;
+  uint32_t size        = parent_pcb->stack_size;
+
+  // find stack pointer location within stack
+  int sp_location = current_tos - ctx->sp;
+
+  // put child's stack pointer to correct place within stack
+  child_pcb->ctx.sp = new_tos - sp_location;
+
+  // copy across the current stack into the new stack
+  memcpy((void *) new_tos - size,
+         (void *) current_tos - size,
+         size);
+
+  // return 0 to child process
+  child_pcb->ctx.gpr[0] = 0;
+
+  // return pid of child process to parent process
+  ctx->gpr[0] = child_pcb->pid;
+
+  // have the child's core pick it up, if it is idle
+  if (child_pcb->cpu != cpu_id()) {
+    smp_kick(child_pcb->cpu);
+  }
+
+  return;
+}
+
+
+// create count processes executing from the entry point, each with a fresh
+// stack; the pids are consecutive, so return the first, or -1 if none were
+// created
+void hilevel_spawn(ctx_t *ctx) {
+  uint32_t entry    = ctx->gpr[0];
+  int      priority = (int) ctx->gpr[1];
+  uint32_t size     = ctx->gpr[2] ? stack_round(ctx->gpr[2]) : STACK_SIZE;
+  int      count    = (int) ctx->gpr[3];
+  uint32_t tos[SPAWN_MAX];
+
+  ctx->gpr[0] = -1;
+
+  if (count <= 0 || count > SPAWN_MAX) {
+    return;
+  }
+
+  // allocate every stack up front, st. either all processes are created or none
+  for (int i = 0; i < count; i++) {
+    tos[i] = stack_alloc(size);
+
+    if (tos[i] == 0) {
+      while (i-- > 0) {
+        stack_free(tos[i], size);
+      }
+      return;
+    }
+  }
+
+  pcb_t *parent_pcb = get_current_process(pcb_ring);
+  pid_t  first      = next_pid();
+
+  for (int i = count - 1; i >= 0; i--) {
+    // unlike exec, there is nothing to overwrite, so only the stack is poisoned
+    stack_poison(tos[i], size);
+
+    // order = cpsr, pc, sp
+    ctx_t *child_ctx = create_ctx((uint32_t) 0x50, entry, tos[i]);
+
+    pcb_t *child_pcb = create_pcb(first + i, priority, child_ctx);
+    child_pcb->stack_tos  = tos[i];
+    child_pcb->stack_size = size;
+    child_pcb->group      = parent_pcb->group;
+    child_pcb->cpu        = smp_place();
+    child_pcb->ppid       = parent_pcb->pid;
+
+    kfree(child_ctx);
+
+    // insert in reverse, st. the children follow the parent in pid order
+    insert_after(pcb_ring, child_pcb);
+
+    if (child_pcb->cpu != cpu_id()) {
+      smp_kick(child_pcb->cpu);
+    }
+  }
+
+  ctx->gpr[0] = first;
+}
+
+
+// load new program image to be executed, with an optional stack size hint
+void hilevel_exec(ctx_t* ctx) {
+  pcb_t *pcb = get_current_process(pcb_ring);
+
+  // a hint of 0 keeps the current stack size
+  uint32_t size = ctx->gpr[1] ? stack_round(ctx->gpr[1]) : pcb->stack_size;
+
+  if (size != pcb->stack_size) {
+    stack_free(pcb->stack_tos, pcb->stack_size);
+
+    uint32_t new_tos = stack_alloc(size);
+
+    // fall back to the original size, which was just freed, if need be
+    if (new_tos == 0) {
+      size    = pcb->stack_size;
+      new_tos = stack_alloc(size);
+    }
+
+    pcb->stack_tos  = new_tos;
+    pcb->stack_size = size;
+  }
+
+  // poison the stack, both for security and to track its high-water mark
+  stack_poison(pcb->stack_tos, pcb->stack_size);
+  pcb->stack_overflow = false;
+
+  fpu_exit(pcb);
+
+  // initialise stack pointer to start of stack
+  ctx->sp = pcb->stack_tos;
+
+  // set pc to entry point of new function
+  ctx->pc = ctx->gpr[0];
+
+  // set gprs to 0 for security
+  for (int i = 0; i < 13; i++) {
+    ctx->gpr[i] = 0;
+  }
+
+  return;
+}
+
+
+// find program in pcb list and remove it, then switch to the next process
+void hilevel_exit(ctx_t* ctx) {
+  terminate(ctx, ctx->gpr[0]);
+}
+
+
+// terminate process pid, with an exit status recording the signal; return 0
+// iff. success
+void hilevel_kill(ctx_t *ctx) {
+  pid_t  pid    = (pid_t) ctx->gpr[0];
+  int    status = EXIT_KILLED | (int) ctx->gpr[1];
+  pcb_t *pcb    = get_process_by_id(pcb_ring, pid);
+
+  // the idle processes are not to be killed
+  if (pcb == NULL || pid < 0) {
+    ctx->gpr[0] = -1;
+    return;
+  }
+
+  ctx->gpr[0] = 0;
+
+  if (pcb == get_current_process(pcb_ring)) {
+    terminate(ctx, status);
+  }
+  else if (pcb->running) {
+    // another core is running it, so have that core terminate it
+    pcb->status = status;
+    pcb->killed = true;
+    smp_kick(pcb->cpu);
+  }
+  else {
+    pcb->status = status;
+
+    pid_t current_pid = get_current_pid(pcb_ring);
+
+    locate_by_id(pcb_ring, pid);
+    delete(pcb_ring);
+    locate_by_id(pcb_ring, current_pid);
+
+    reclaim(pcb);
+  }
+}
+
+
+// collect the status of an exited child (pid < 0 => any child) into x,
+// blocking until one exits unless WAIT_NOHANG; return its pid, 0 if none
+// has exited and the caller won't wait, or -1 if there is no such child
+void hilevel_waitpid(ctx_t *ctx) {
+  pid_t pid   = (pid_t) ctx->gpr[0];
+  int  *x     = (int *) ctx->gpr[1];
+  int   flags = (int) ctx->gpr[2];
+
+  pcb_t *pcb = get_current_process(pcb_ring);
+
+  // the only zombies are those not yet collected, so this is short
+  for (Node *node = zombie_ring->first->next; !is_sentinel(node); node = node->next) {
+    pcb_t *child = (pcb_t *) node->item;
+
+    if (child->ppid == pcb->pid && (pid < 0 || child->pid == pid)) {
+      if (x != NULL) {
+        *x = child->status;
+      }
+      ctx->gpr[0] = child->pid;
+
+      locate_by_id(zombie_ring, child->pid);
+      delete(zombie_ring);
+      kfree(child);
+      return;
+    }
+  }
+
+  pcb_t *child = NULL;
+
+  for (Node *node = pcb_ring->first->next; !is_sentinel(node); node = node->next) {
+    pcb_t *live = (pcb_t *) node->item;
+
+    if (live->ppid == pcb->pid && (pid < 0 || live->pid == pid)) {
+      child = live;
+      break;
+    }
+  }
+
+  if (child == NULL) {
+    ctx->gpr[0] = -1;
+    return;
+  }
+  if (flags & WAIT_NOHANG) {
+    ctx->gpr[0] = 0;
+    return;
+  }
+
+  // block until a child exits, after which the caller waits again; a child
+  // waited for by pid inherits the priority of the caller meanwhile
+  pcb->wait   = (uint32_t) pcb;
+  pcb->holder = (pid < 0) ? 0 : child->pid;
+  sched_throttle(pcb);
+
+  ctx->gpr[0] = WAIT_AGAIN;
+  scheduler(ctx, SCHED_BLOCK);
+}
+
+
+// create a thread of the current process, executing from the entry point
+// with its own stack but otherwise sharing everything
+void hilevel_thread_create(ctx_t *ctx) {
+  pcb_t   *parent_pcb = get_current_process(pcb_ring);
+  uint32_t size       = ctx->gpr[3] ? stack_round(ctx->gpr[3]) : STACK_SIZE;
+  uint32_t new_tos    = stack_alloc(size);
+
+  if (new_tos == 0) {
+    ctx->gpr[0] = -1;
+    return;
+  }
+
+  stack_poison(new_tos, size);
+
+  // order = cpsr, pc, sp
+  ctx_t *thread_ctx = create_ctx((uint32_t) 0x50, ctx->gpr[0], new_tos);
+  thread_ctx->gpr[0] = ctx->gpr[1];
+  thread_ctx->gpr[1] = ctx->gpr[2];
+
+  pcb_t *thread_pcb = create_pcb(next_pid(), parent_pcb->priority, thread_ctx);
+  thread_pcb->stack_tos  = new_tos;
+  thread_pcb->stack_size = size;
+  thread_pcb->group      = parent_pcb->group;
+  thread_pcb->cpu        = smp_place();
+  thread_pcb->tgid       = parent_pcb->tgid;
+  thread_pcb->ppid       = 0; // joined by its group, rather than waited for
+
+  kfree(thread_ctx);
+
+  insert_after(pcb_ring, thread_pcb);
+
+  if (thread_pcb->cpu != cpu_id()) {
+    smp_kick(thread_pcb->cpu);
+  }
+
+  ctx->gpr[0] = thread_pcb->pid;
+}
+
+
+// collect the status of an exited thread of the current process, blocking
+// until it exits
+void hilevel_thread_join(ctx_t *ctx) {
+  pid_t tid = (pid_t) ctx->gpr[0];
+  int  *x   = (int *) ctx->gpr[1];
+
+  pcb_t *pcb    = get_current_process(pcb_ring);
+  pcb_t *thread = get_process_by_id(zombie_ring, tid);
+
+  if (thread != NULL && thread->tgid == pcb->tgid) {
+    if (x != NULL) {
+      *x = thread->status;
+    }
+
+    locate_by_id(zombie_ring, tid);
+    delete(zombie_ring);
+    kfree(thread);
+
+    ctx->gpr[0] = 0;
+    return;
+  }
+
+  thread = get_process_by_id(pcb_ring, tid);
+
+  if (thread == NULL || thread == pcb || thread->tgid != pcb->tgid) {
+    ctx->gpr[0] = -1;
+    return;
+  }
+
+  // block until the thread exits, after which the caller joins again; the
+  // thread inherits the priority of the caller meanwhile
+  pcb->wait   = (uint32_t) thread;
+  pcb->holder = thread->pid;
+  sched_throttle(pcb);
+
+  ctx->gpr[0] = THREAD_AGAIN;
+  scheduler(ctx, SCHED_BLOCK);
+}
+
+
+// create a pipe
+void hilevel_pipe_open(ctx_t *ctx) {
+  // if space for free pipes
+  pipe_t *new_pipe = create_pipe((pid_t) ctx->gpr[0], (pid_t) ctx->gpr[1], -1, OPEN);
+  insert_after(pipe_ring, new_pipe);
+  ctx->gpr[0] = new_pipe->pid;
+
+  return;
+}
+
+
+// write data to pipe
+void hilevel_pipe_write( ctx_t *ctx ) {
+  pid_t pipe_id = ctx->gpr[0];
+  int   data    = ctx->gpr[1];
+
+  int success = locate_by_pipe_id(pipe_ring, pipe_id);
+  if (success) {
+    // check program has permission to write to pipe
+    if (get_current_pipe(pipe_ring)->proc1 == get_current_pipe_id(pipe_ring) || get_current_pipe(pipe_ring)->proc2 == get_current_pipe_id(pipe_ring)) {
+      get_current_pipe(pipe_ring)->value = data;
+      stats.pipe_writes++;
+      poll_wake(false);
+    }
+  }
+
+  return;
+}
+
+// check data in pipe
+void hilevel_pipe_check( ctx_t *ctx ) {
+  pid_t pipe_id = ctx->gpr[0];
+  int c_value = ctx->gpr[1];
+  ctx->gpr[0] = 0;
+
+   int success = locate_by_pipe_id(pipe_ring, pipe_id);
+
+   if (success) {
+    // check program has permission to read from pipe
+    if (get_current_pipe(pipe_ring)->proc1 == get_current_pipe_id(pipe_ring) || get_current_pipe(pipe_ring)->proc2 == get_current_pipe_id(pipe_ring)) {
+
+      // return value to calling function
+      if (get_current_pipe(pipe_ring)->value == c_value) {
+        ctx->gpr[0] = 1;
+      } else {
+        ctx->gpr[0] = 0;
+      }
+    }
+  }
+
+  return;
+}
+
+
+//read data from pipe
+void hilevel_pipe_read( ctx_t *ctx ) {
+  pid_t pipe_id = ctx->gpr[0];
+  ctx->gpr[0] = -1;
+
+   int success = locate_by_pipe_id(pipe_ring, pipe_id);
+
+   if (success) {
+    // check program has permission to read from pipe
+    if (get_current_pipe(pipe_ring)->proc1 == get_current_pipe_id(pipe_ring) || get_current_pipe(pipe_ring)->proc2 == get_current_pipe_id(pipe_ring)) {
+
+      // return value to calling function
+      ctx->gpr[0] = get_current_pipe(pipe_ring)->value;
+
+      if ((int) ctx->gpr[0] == -1) {
+        stats.pipe_empty++;
+      } else {
+        stats.pipe_reads++;
+      }
+
+      // reset pipe value to prevent multiple reads
+      get_current_pipe(pipe_ring)->value = -1;
+      poll_wake(false);
+    }
+  }
+
+  return;
+}
+
+
+// close existing pipe
+void hilevel_pipe_close(ctx_t *ctx) {
+  int pipe_id = ctx->gpr[0];
+
+  int success = locate_by_pipe_id(pipe_ring, pipe_id);
+
+  if (success) {
+    // check program has permission to close pipe
+    if (get_current_pipe(pipe_ring)->proc1 == get_current_pipe_id(pipe_ring) || get_current_pipe(pipe_ring)->proc2 == get_current_pipe_id(pipe_ring)) {
+      pipe_t *pipe = get_current_pipe(pipe_ring);
+      delete(pipe_ring);
+      kfree(pipe);
+      poll_wake(false);
+    }
+  }
+
+  return;
+}
+
+
+// get process id of current process
+void hilevel_get_proc_id( ctx_t *ctx ) {
+  // return pid to calling function
+  ctx->gpr[0] = get_current_pid(pcb_ring);
+  return;
+}
+
+
+// open a performance counter for an event on a process (0 => current)
+void hilevel_pmu_open( ctx_t *ctx ) {
+  pid_t    pid   = ( pid_t    )( ctx->gpr[ 0 ] );
+  uint32_t event = ( uint32_t )( ctx->gpr[ 1 ] );
+  ctx->gpr[ 0 ] = -1;
+
+  pcb_t *current = get_current_process(pcb_ring);
+  pcb_t *pcb     = (pid == 0) ? current : get_process_by_id(pcb_ring, pid);
+
+  if (pcb == NULL) {
+    return;
+  }
+
+  pmu_save(current);
+
+  if (pmu_find(pcb, event) != -1) {
+    ctx->gpr[ 0 ] = 0;
+  }
+  else if (event == PMU_EVENT_CYCLES) {
+    pcb->pmu.mask |= (1U << PMU_CYCLE_COUNTER);
+    pcb->pmu.ccnt  = 0;
+    ctx->gpr[ 0 ] = 0;
+  }
+  else {
+    // allocate the first free event counter
+    for (int i = 0; i < PMU_COUNTERS; i++) {
+      if (!(pcb->pmu.mask & (1 << i))) {
+        pcb->pmu.mask    |= (1 << i);
+        pcb->pmu.event[i] = event;
+        pcb->pmu.count[i] = 0;
+        ctx->gpr[ 0 ] = 0;
+        break;
+      }
+    }
+  }
+
+  pmu_restore(current);
+}
+
+
+// read the virtualised count for an event on a process (0 => current)
+void hilevel_pmu_read( ctx_t *ctx ) {
+  pid_t    pid   = ( pid_t    )( ctx->gpr[ 0 ] );
+  uint32_t event = ( uint32_t )( ctx->gpr[ 1 ] );
+  ctx->gpr[ 0 ] = 0;
+
+  pcb_t *current = get_current_process(pcb_ring);
+  pcb_t *pcb     = (pid == 0) ? current : get_process_by_id(pcb_ring, pid);
+
+  if (pcb == NULL) {
+    return;
+  }
+
+  // bring the saved counts of the running process up to date
+  pmu_save(current);
+
+  int i = pmu_find(pcb, event);
+  if      (i == PMU_CYCLE_COUNTER) {
+    ctx->gpr[ 0 ] = pcb->pmu.ccnt;
+  }
+  else if (i != -1) {
+    ctx->gpr[ 0 ] = pcb->pmu.count[i];
+  }
+
+  pmu_restore(current);
+}
+
+
+// close the counter for an event on a process (0 => current)
+void hilevel_pmu_close( ctx_t *ctx ) {
+  pid_t    pid   = ( pid_t    )( ctx->gpr[ 0 ] );
+  uint32_t event = ( uint32_t )( ctx->gpr[ 1 ] );
+
+  pcb_t *current = get_current_process(pcb_ring);
+  pcb_t *pcb     = (pid == 0) ? current : get_process_by_id(pcb_ring, pid);
+
+  if (pcb == NULL) {
+    return;
+  }
+
+  pmu_save(current);
+
+  int i = pmu_find(pcb, event);
+  if (i != -1) {
+    pcb->pmu.mask &= ~(1 << i);
+  }
+
+  pmu_restore(current);
+}
+
+
+// start the sampling profiler with the given period
+void hilevel_prof_start( ctx_t *ctx ) {
+  prof_start( ( uint32_t )( ctx->gpr[ 0 ] ) );
+}
+
+
+// stop the sampling profiler
+void hilevel_prof_stop( ctx_t *ctx ) {
+  ( void ) ctx;
+
+  prof_stop();
+}
+
+
+// dump the profile histogram over the same UART as write
+void hilevel_prof_dump( ctx_t *ctx ) {
+  ( void ) ctx;
+
+  prof_dump( UART0 );
+}
+
+
+// copy the kernel statistics into the buffer provided
+void hilevel_stats( ctx_t *ctx ) {
+  stats_copy( ( stats_t* )( ctx->gpr[ 0 ] ) );
+}
+
+
+// report stack size, high-water mark and overflow of a process (0 => current)
+void hilevel_stack_stat( ctx_t *ctx ) {
+  pid_t     pid = ( pid_t     )( ctx->gpr[ 0 ] );
+  uint32_t* x   = ( uint32_t* )( ctx->gpr[ 1 ] );
+  ctx->gpr[ 0 ] = -1;
+
+  pcb_t *pcb = (pid == 0) ? get_current_process(pcb_ring) : get_process_by_id(pcb_ring, pid);
+
+  if (pcb == NULL) {
+    return;
+  }
+
+  // order = size, used, overflow
+  x[ 0 ] = pcb->stack_size;
+  x[ 1 ] = stack_used(pcb->stack_tos, pcb->stack_size);
+  x[ 2 ] = pcb->stack_overflow;
+
+  ctx->gpr[ 0 ] = 0;
+}
+
+
+// copy the kernel memory statistics into the buffer provided
+void hilevel_kmem_stat( ctx_t *ctx ) {
+  kmem_copy( ( kmem_stat_t* )( ctx->gpr[ 0 ] ) );
+}
+
+
+// report leaked kernel objects over the same UART as write
+void hilevel_kmem_leaks( ctx_t *ctx ) {
+  ctx->gpr[ 0 ] = kmem_leaks( UART0 );
+}
+
+
+// register an output buffer claimed by the current process, st. it is
+// flushed and released even if the process is killed
+void hilevel_outbuf_claim( ctx_t *ctx ) {
+  ctx->gpr[ 0 ] = outbuf_claim( get_current_process( pcb_ring ), ( outbuf_t* )( ctx->gpr[ 0 ] ) );
+}
+
+
+// read clock id into the buffer provided, as seconds plus nanoseconds
+void hilevel_clock_gettime( ctx_t *ctx ) {
+  int       id = ( int       )( ctx->gpr[ 0 ] );
+  uint32_t* x  = ( uint32_t* )( ctx->gpr[ 1 ] );
+
+  if( id != CLOCK_MONOTONIC ) {
+    ctx->gpr[ 0 ] = -1;
+    return;
+  }
+
+  uint64_t t = clock_read();
+
+  // order = sec, nsec
+  x[ 0 ] = t / CLOCK_HZ;
+  x[ 1 ] = ( t % CLOCK_HZ ) * ( 1000000000 / CLOCK_HZ );
+
+  ctx->gpr[ 0 ] = 0;
+}
+
+
+// make the current process periodic real-time, subject to admission
+void hilevel_sched_rt( ctx_t *ctx ) {
+  uint32_t period   = ( uint32_t )( ctx->gpr[ 0 ] );
+  uint32_t budget   = ( uint32_t )( ctx->gpr[ 1 ] );
+  uint32_t deadline = ( uint32_t )( ctx->gpr[ 2 ] );
+
+  ctx->gpr[ 0 ] = sched_rt( get_current_process( pcb_ring ), period, budget, deadline );
+}
+
+
+// get number of deadline misses of a process (0 => current)
+void hilevel_rt_misses( ctx_t *ctx ) {
+  pid_t pid = ( pid_t )( ctx->gpr[ 0 ] );
+
+  pcb_t *pcb = (pid == 0) ? get_current_process(pcb_ring) : get_process_by_id(pcb_ring, pid);
+
+  ctx->gpr[ 0 ] = (pcb == NULL) ? -1 : (int) pcb->rt.misses;
+}
+
+
+// switch the scheduling policy
+void hilevel_sched_policy( ctx_t *ctx ) {
+  int policy = ( int )( ctx->gpr[ 0 ] );
+
+  ctx->gpr[ 0 ] = sched_set_policy( policy );
+}
+
+
+// create a process group with a CPU quota per period
+void hilevel_group_create( ctx_t *ctx ) {
+  uint32_t quota  = ( uint32_t )( ctx->gpr[ 0 ] );
+  uint32_t period = ( uint32_t )( ctx->gpr[ 1 ] );
+
+  ctx->gpr[ 0 ] = sched_group_create( quota, period );
+}
+
 
-  // insert new child pcb into ring after current pcb
-  insert_after(pcb_ring, child_pcb);
+// move a process (0 => current) into a process group
+void hilevel_group_move( ctx_t *ctx ) {
+  pid_t pid   = ( pid_t )( ctx->gpr[ 0 ] );
+  int   group = ( int   )( ctx->gpr[ 1 ] );
 
-  // find top of stack for for child and current program
-  int new_tos     = (int) &tos_user_progs - child_pcb->pid            * STACK_SIZE;
-  int current_tos = (int) &tos_user_progs - get_current_pid(pcb_ring) * STACK_SIZE;
+  pcb_t *pcb = (pid == 0) ? get_current_process(pcb_ring) : get_process_by_id(pcb_ring, pid);
 
-  // find stack pointer location within stack
-  int sp_location = current_tos - ctx->sp;
+  ctx->gpr[ 0 ] = (pcb == NULL) ? -1 : sched_group_move( pcb, group );
+}
 
-  // put child's stack pointer to correct place within stack
-  child_pcb->ctx.sp = new_tos - sp_location;
 
-  // copy across the current stack into the new stack
-  memcpy((void *) new_tos - STACK_SIZE,
-         (void *) current_tos - STACK_SIZE,
-         STACK_SIZE);
+// block the current process until woken via the address, iff. it still holds the
+// value, noting which process (if any) holds what it waits for
+void futex_block( ctx_t *ctx, pid_t holder ) {
+  uint32_t x = ( uint32_t )( ctx->gpr[ 0 ] );
+  int      v = ( int      )( ctx->gpr[ 1 ] );
 
-  // return 0 to child process
-  child_pcb->ctx.gpr[0] = 0;
+  // the value may have changed since the process last looked, i.e., the
+  // wake up it would wait for may already have happened
+  if( *( volatile int* )( x ) != v ) {
+    ctx->gpr[ 0 ] = -1;
+    return;
+  }
 
-  // return pid of child process to parent process
-  ctx->gpr[0] = child_pcb->pid;
+  pcb_t *pcb = get_current_process( pcb_ring );
+  pcb->wait   = x;
+  pcb->holder = holder;
+  sched_throttle( pcb );
 
-  return;
+  ctx->gpr[ 0 ] = 0;
+  scheduler( ctx, SCHED_BLOCK );
 }
 
+void hilevel_futex_wait( ctx_t *ctx ) {
+  futex_block( ctx, 0 );
+}
 
-// load new program image to be executed
-void hilevel_exec(ctx_t* ctx) {
-  // get current top of stack
-  int current_tos = (int) &tos_user_progs - get_current_pid(pcb_ring) * STACK_SIZE;
+// as futex_wait, but the value is the pid of the lock holder (plus maybe
+// FUTEX_WAITERS), which inherits the priority of the caller while it waits
+void hilevel_futex_wait_pi( ctx_t *ctx ) {
+  futex_block( ctx, ( pid_t )( ctx->gpr[ 1 ] & ~FUTEX_WAITERS ) );
+}
 
-  // initialise stack zeros for security
-  memset((void *) current_tos - STACK_SIZE,
-         0,
-         STACK_SIZE);
+// wake up to n processes blocked on the address
+void hilevel_futex_wake( ctx_t *ctx ) {
+  uint32_t x = ( uint32_t )( ctx->gpr[ 0 ] );
+  int      n = ( int      )( ctx->gpr[ 1 ] );
 
-  // initialise stack pointer to start of stack
-  ctx->sp = current_tos;
+  ctx->gpr[ 0 ] = wake( x, n );
+}
 
-  // set pc to entry point of new function
-  ctx->pc = ctx->gpr[0];
 
-  // set gprs to 0 for security
-  for (int i = 0; i < 13; i++) {
-    ctx->gpr[i] = 0;
+// create a shared memory segment of (at least) n bytes
+void hilevel_shm_create( ctx_t *ctx ) {
+  uint32_t n  = ( uint32_t )( ctx->gpr[ 0 ] );
+  int      id = shm_create( n );
+
+  // the creator is attached, st. the segment is freed even if nobody else
+  // ever attaches to it
+  if( id != -1 ) {
+    shm_attach( get_current_process( pcb_ring ), id );
   }
 
-  return;
+  ctx->gpr[ 0 ] = id;
 }
 
+// attach the current process to a shared memory segment, returning its address
+void hilevel_shm_attach( ctx_t *ctx ) {
+  int id = ( int )( ctx->gpr[ 0 ] );
 
-// find program in pcb list and remove it
-void hilevel_exit(ctx_t* ctx) {
-  delete(pcb_ring);
-  locate_next_pid(pcb_ring);
+  ctx->gpr[ 0 ] = shm_attach( get_current_process( pcb_ring ), id );
 }
 
+// detach the current process from a shared memory segment
+void hilevel_shm_detach( ctx_t *ctx ) {
+  int id = ( int )( ctx->gpr[ 0 ] );
 
-// create a pipe
-void hilevel_pipe_open(ctx_t *ctx) {
-  // if space for free pipes
-  pipe_t *new_pipe = create_pipe((pid_t) ctx->gpr[0], (pid_t) ctx->gpr[1], -1, OPEN);
-  insert_after(pipe_ring, new_pipe);
-  ctx->gpr[0] = new_pipe->pid;
-
-  return;
+  ctx->gpr[ 0 ] = shm_detach( get_current_process( pcb_ring ), id );
 }
 
 
-// write data to pipe
-void hilevel_pipe_write( ctx_t *ctx ) {
-  pid_t pipe_id = ctx->gpr[0];
-  int   data    = ctx->gpr[1];
+// wait until any of n descriptors is ready, or timeout ticks pass
+void hilevel_poll( ctx_t *ctx ) {
+  pollfd_t *fds     = ( pollfd_t* )( ctx->gpr[ 0 ] );
+  int       n       = ( int       )( ctx->gpr[ 1 ] );
+  int       timeout = ( int       )( ctx->gpr[ 2 ] );
 
-  int success = locate_by_pipe_id(pipe_ring, pipe_id);
-  if (success) {
-    // check program has permission to write to pipe
-    if (get_current_pipe(pipe_ring)->proc1 == get_current_pipe_id(pipe_ring) || get_current_pipe(pipe_ring)->proc2 == get_current_pipe_id(pipe_ring)) {
-      get_current_pipe(pipe_ring)->value = data;
-    }
+  pcb_t *pcb = get_current_process( pcb_ring );
+
+  // a retry after a spurious wakeup resumes the timeout where it left off
+  if( pcb->poll_again ) {
+    timeout         = pcb->poll_left;
+    pcb->poll_again = false;
   }
 
-  return;
-}
+  int r = poll_scan( fds, n );
 
-// check data in pipe
-void hilevel_pipe_check( ctx_t *ctx ) {
-  pid_t pipe_id = ctx->gpr[0];
-  int c_value = ctx->gpr[1];
-  ctx->gpr[0] = 0;
+  if( r > 0 || timeout == 0 || n <= 0 ) {
+    ctx->gpr[ 0 ] = r;
+    return;
+  }
 
-   int success = locate_by_pipe_id(pipe_ring, pipe_id);
+  poll_block( pcb, fds, n, timeout );
 
-   if (success) {
-    // check program has permission to read from pipe
-    if (get_current_pipe(pipe_ring)->proc1 == get_current_pipe_id(pipe_ring) || get_current_pipe(pipe_ring)->proc2 == get_current_pipe_id(pipe_ring)) {
+  // overwritten by poll_wake, unless the process wakes up spuriously
+  ctx->gpr[ 0 ] = POLL_AGAIN;
+  scheduler( ctx, SCHED_BLOCK );
+}
 
-      // return value to calling function
-      if (get_current_pipe(pipe_ring)->value == c_value) {
-        ctx->gpr[0] = 1;
-      } else {
-        ctx->gpr[0] = 0;
-      }
-    }
-  }
 
-  return;
+// open a broadcast channel
+void hilevel_chan_open( ctx_t *ctx ) {
+  ctx->gpr[ 0 ] = chan_open();
 }
 
+// close a broadcast channel, waking any subscriber waiting on it
+void hilevel_chan_close( ctx_t *ctx ) {
+  int id = ( int )( ctx->gpr[ 0 ] );
 
-//read data from pipe
-void hilevel_pipe_read( ctx_t *ctx ) {
-  pid_t pipe_id = ctx->gpr[0];
-  ctx->gpr[0] = -1;
+  ctx->gpr[ 0 ] = chan_close( id );
 
-   int success = locate_by_pipe_id(pipe_ring, pipe_id);
+  if( ctx->gpr[ 0 ] == 0 ) {
+    wake( chan_addr( id ), CHAN_SUBS );
+  }
+}
 
-   if (success) {
-    // check program has permission to read from pipe
-    if (get_current_pipe(pipe_ring)->proc1 == get_current_pipe_id(pipe_ring) || get_current_pipe(pipe_ring)->proc2 == get_current_pipe_id(pipe_ring)) {
+// subscribe the current process to a broadcast channel
+void hilevel_chan_subscribe( ctx_t *ctx ) {
+  int id = ( int )( ctx->gpr[ 0 ] );
 
-      // return value to calling function
-      ctx->gpr[0] = get_current_pipe(pipe_ring)->value;
+  ctx->gpr[ 0 ] = chan_subscribe( get_current_pid( pcb_ring ), id );
+}
 
-      // reset pipe value to prevent multiple reads
-      get_current_pipe(pipe_ring)->value = -1;
-    }
-  }
+// publish a message on a broadcast channel, waking any subscriber waiting on it
+void hilevel_chan_publish( ctx_t *ctx ) {
+  int id = ( int )( ctx->gpr[ 0 ] );
+  int x  = ( int )( ctx->gpr[ 1 ] );
 
-  return;
+  ctx->gpr[ 0 ] = chan_publish( id, x );
+
+  if( ( int )( ctx->gpr[ 0 ] ) != -1 ) {
+    wake( chan_addr( id ), CHAN_SUBS );
+  }
 }
 
+// read the next message from a broadcast channel, blocking if there is none
+void hilevel_chan_read( ctx_t *ctx ) {
+  int  id = ( int  )( ctx->gpr[ 0 ] );
+  int*  x = ( int* )( ctx->gpr[ 1 ] );
 
-// close existing pipe
-void hilevel_pipe_close(ctx_t *ctx) {
-  int pipe_id = ctx->gpr[0];
+  ctx->gpr[ 0 ] = chan_read( get_current_pid( pcb_ring ), id, x );
 
-  int success = locate_by_pipe_id(pipe_ring, pipe_id);
+  // block until the next publish, after which the caller reads again
+  if( ( int )( ctx->gpr[ 0 ] ) == CHAN_AGAIN ) {
+    pcb_t *pcb = get_current_process( pcb_ring );
+    pcb->wait   = chan_addr( id );
+    pcb->holder = 0;
+    sched_throttle( pcb );
 
-  if (success) {
-    // check program has permission to close pipe
-    if (get_current_pipe(pipe_ring)->proc1 == get_current_pipe_id(pipe_ring) || get_current_pipe(pipe_ring)->proc2 == get_current_pipe_id(pipe_ring)) {
-      delete(pipe_ring);
-    }
+    scheduler( ctx, SCHED_BLOCK );
   }
+}
 
-  return;
+
+// register the submission and completion rings of the current process
+void hilevel_uring_setup( ctx_t *ctx ) {
+  uring_t *ring = ( uring_t* )( ctx->gpr[ 0 ] );
+
+  uring_setup( get_current_process( pcb_ring ), ring );
+
+  ctx->gpr[ 0 ] = 0;
 }
 
+// consume the queued submissions of the current process
+void hilevel_uring_enter( ctx_t *ctx ) {
+  pcb_t *pcb = get_current_process( pcb_ring );
 
-// get process id of current process
-void hilevel_get_proc_id( ctx_t *ctx ) {
-  // return pid to calling function
-  ctx->gpr[0] = get_current_pid(pcb_ring);
-  return;
+  ctx->gpr[ 0 ] = ( pcb->uring == NULL ) ? -1 : uring_run( pcb, false );
 }
 
 
@@ -254,8 +1205,14 @@ void hilevel_handler_rst( ctx_t* ctx ) {
    * - configuring GIC st. the selected interrupts are forwarded to the
    *   processor via the IRQ interrupt signal, then
    * - enabling IRQ interrupts.
+   *
+   * Before anything else, though, the MMU is enabled with an identity
+   * mapping, st. the caches can be too.
    */
 
+  vm_init();
+  vm_cpu_init();
+
   TIMER0->Timer1Load  = 0x00001000; // select period = 2^20 ticks ~= 1 sec
   TIMER0->Timer1Ctrl  = 0x00000002; // select 32-bit   timer
   TIMER0->Timer1Ctrl |= 0x00000040; // select periodic timer
@@ -264,32 +1221,110 @@ void hilevel_handler_rst( ctx_t* ctx ) {
 
   GICC0->PMR          = 0x000000F0; // unmask all            interrupts
   GICD0->ISENABLER1  |= 0x00000010; // enable timer          interrupt
+  GICD0->ISENABLER1  |= 0x00000020; // enable profiling timer interrupt
+  GICD0->ISENABLER1  |= 0x00002000; // enable console UART    interrupt
   GICC0->CTLR         = 0x00000001; // enable GIC interface
   GICD0->CTLR         = 0x00000001; // enable GIC distributor
 
+  pmu_enable();                     // enable PMU, but with every
+  pmu_set_cnt_off( 0xFFFFFFFF );    // counter off until a process opens one
+
+  fpu_init();                       // allow VFP use, trapped until a process uses it
+
   /*
    * - The CPSR value of 0x50 means the processor is switched into USR
    *   mode, with IRQ interrupts enabled, and
    * - The PC and SP values match the entry point and top of stack.
    */
+  clock_init();
+  stats_init();
+  sched_init(SCHED_POLICY);
+
   pipe_ring = create_ring();
   pcb_ring  = create_ring();
+  zombie_ring = create_ring();
+
+  uint32_t initial_tos = stack_alloc(STACK_SIZE);
+  stack_poison(initial_tos, STACK_SIZE);
 
   // order = cpsr, pc, sp
-  ctx_t *initial_ctx = create_ctx((uint32_t) 0x50, (uint32_t) &main_console, (uint32_t) &tos_user_progs);
+  ctx_t *initial_ctx = create_ctx((uint32_t) 0x50, (uint32_t) &main_console, initial_tos);
 
   // set up initial process
   // order = pid, priority, status, ctx
-  pcb_t *initial_pcb = create_pcb(get_max_pid(pcb_ring) + 1, 10, initial_ctx);
+  pcb_t *initial_pcb = create_pcb(next_pid(), 10, initial_ctx);
+  initial_pcb->stack_tos  = initial_tos;
+  initial_pcb->stack_size = STACK_SIZE;
+
+  // the pcb holds a copy of the context, so the original can go
+  kfree(initial_ctx);
 
   insert_after(pcb_ring, initial_pcb);
+
+#if CPUS > 1
+  GICD0->ITARGETSR[  9 ] |= 0x00000101; // route TIMER0 and TIMER1 to core 0
+  GICD0->ITARGETSR[ 11 ] |= 0x00000100; // route UART1            to core 0
+#endif
+
+  // each core gets an idle process, homed on it, to fall back on (even if
+  // there is only one, st. there is always something to dispatch)
+  for (int i = 0; i < CPUS; i++) {
+    uint32_t idle_tos = stack_alloc(STACK_UNIT);
+    stack_poison(idle_tos, STACK_UNIT);
+
+    ctx_t *idle_ctx = create_ctx((uint32_t) 0x50, (uint32_t) &main_idle, idle_tos);
+    pcb_t *idle_pcb = create_pcb(-1 - i, 0, idle_ctx);
+    idle_pcb->stack_tos  = idle_tos;
+    idle_pcb->stack_size = STACK_UNIT;
+    idle_pcb->cpu        = i;
+    idle_pcb->throttled  = true;
+
+    kfree(idle_ctx);
+
+    insert_before(pcb_ring, idle_pcb);
+  }
+
   // set the current pointer to inital process
-  set_first(pcb_ring);
+  locate_by_id(pcb_ring, initial_pcb->pid);
+  initial_pcb->running = true;
 
   // copy the context of the initial program into the passed in context
   memcpy(ctx,
          &initial_pcb->ctx,
          sizeof(ctx_t));
+  smp_set_tls(initial_pcb->pid);
+
+#if CPUS > 1
+  smp_init_cpu();
+  kernel_unlock(); // record core 0's current process before others start
+  smp_boot();
+#endif
+
+  int_enable_irq();
+
+  return;
+}
+
+
+// handle the start of a secondary core, which begins by running its idle process
+void hilevel_handler_smp( ctx_t* ctx ) {
+  vm_cpu_init();
+  smp_init_cpu();
+  fpu_init();
+
+  kernel_lock();
+
+  locate_by_id( pcb_ring, -1 - cpu_id() );
+
+  pcb_t *idle_pcb = get_current_process( pcb_ring );
+  idle_pcb->running = true;
+
+  memcpy( ctx,
+          &idle_pcb->ctx,
+          sizeof( ctx_t ) );
+  smp_set_tls( idle_pcb->pid );
+
+  kernel_unlock();
 
   int_enable_irq();
 
@@ -301,20 +1336,53 @@ void hilevel_handler_rst( ctx_t* ctx ) {
 void hilevel_handler_irq(ctx_t* ctx) {
   int_unable_irq();
 
+  kernel_lock();
+
   // read  the interrupt identifier so we know the source.
   uint32_t id = GICC0->IAR;
 
+  stats_irq( id );
+
   // handle the interrupt, then clear (or reset) the source.
   if ( id == GIC_SOURCE_TIMER0 ) {
 
-    scheduler( ctx );
+    clock_tick();
+    poll_wake( true );
+    uring_tick();
+    scheduler( ctx, SCHED_TICK );
 
     TIMER0->Timer1IntClr = 0x01; // reset timer
   }
+  else if ( id == GIC_SOURCE_TIMER1 ) {
+
+    prof_sample( get_current_pid( pcb_ring ), ctx->pc );
+
+    TIMER1->Timer1IntClr = 0x01; // reset timer
+  }
+  else if ( id == GIC_SOURCE_UART1 ) {
+
+    UART1->IMSC &= ~0x10; // mask receive interrupt until polled for again
+
+    poll_wake( false );
+  }
+#if CPUS > 1
+  else if ( id == GIC_SOURCE_PTIMER ) {
+
+    scheduler( ctx, SCHED_TICK );
+
+    PTIMER0->IntClr = 0x01; // reset timer
+  }
+  else if ( id == SGI_RESCHED ) {
+
+    scheduler( ctx, SCHED_WAKE );
+  }
+#endif
 
   // write the interrupt identifier to signal we're done.
   GICC0->EOIR = id;
 
+  kernel_unlock();
+
   int_enable_irq();
 
   return;
@@ -322,6 +1390,38 @@ void hilevel_handler_irq(ctx_t* ctx) {
 
 
 // handle supervisor interrupt calls
+// system calls which neither block nor reschedule, so take the fast path:
+// each handler must only use cpsr, pc and gpr[ 0 ] to gpr[ 3 ] of the ctx
+void ( *svc_fast[ SVC_FAST ] )( ctx_t* ctx ) = {
+  [ 0x11 ] = hilevel_get_proc_id,
+  [ 0x14 ] = hilevel_pmu_read,
+  [ 0x19 ] = hilevel_stats,
+  [ 0x1A ] = hilevel_stack_stat,
+  [ 0x1B ] = hilevel_kmem_stat,
+  [ 0x1E ] = hilevel_rt_misses,
+  [ 0x33 ] = hilevel_clock_gettime,
+};
+
+// handle a system call in the svc_fast jump table, where ctx is only saved
+// in part; return false iff. the full path must handle it instead
+bool hilevel_handler_fast(ctx_t* ctx, uint32_t id) {
+  kernel_lock();
+
+  // a process killed on another core is terminated by the full path
+  if( get_current_process( pcb_ring )->killed ) {
+    kernel_unlock();
+    return false;
+  }
+
+  stats_svc( id );
+
+  svc_fast[ id ]( ctx );
+
+  kernel_unlock();
+
+  return true;
+}
+
 void hilevel_handler_svc(ctx_t* ctx, uint32_t id) {
   /* Based on the identified encoded as an immediate operand in the
    * instruction,
@@ -331,9 +1431,13 @@ void hilevel_handler_svc(ctx_t* ctx, uint32_t id) {
    * - write any return value back to preserved usr mode registers.
    */
 
+  kernel_lock();
+
+  stats_svc( id );
+
   switch( id ) {
     case 0x00: { // 0x00 => yield()
-      scheduler( ctx );
+      scheduler( ctx, SCHED_YIELD );
       break;
     }
     case 0x01: { // 0x01 => write( fd, x, n )
@@ -348,10 +1452,14 @@ void hilevel_handler_svc(ctx_t* ctx, uint32_t id) {
       hilevel_exit( ctx );
       break;
     }
-    case 0x05: { // 0x05 => exec()
+    case 0x05: { // 0x05 => exec( x, n )
       hilevel_exec( ctx );
       break;
     }
+    case 0x06: { // 0x06 => kill( pid, x )
+      hilevel_kill( ctx );
+      break;
+    }
     case 0x07: { // 0x05 => pipe_open()
       hilevel_pipe_open( ctx );
       break;
@@ -376,10 +1484,204 @@ void hilevel_handler_svc(ctx_t* ctx, uint32_t id) {
       hilevel_pipe_check( ctx );
       break;
     }
+    case 0x13: { // 0x13 => pmu_open( pid, event )
+      hilevel_pmu_open( ctx );
+      break;
+    }
+    case 0x14: { // 0x14 => pmu_read( pid, event )
+      hilevel_pmu_read( ctx );
+      break;
+    }
+    case 0x15: { // 0x15 => pmu_close( pid, event )
+      hilevel_pmu_close( ctx );
+      break;
+    }
+    case 0x16: { // 0x16 => prof_start( period )
+      hilevel_prof_start( ctx );
+      break;
+    }
+    case 0x17: { // 0x17 => prof_stop()
+      hilevel_prof_stop( ctx );
+      break;
+    }
+    case 0x18: { // 0x18 => prof_dump()
+      hilevel_prof_dump( ctx );
+      break;
+    }
+    case 0x19: { // 0x19 => stats( x )
+      hilevel_stats( ctx );
+      break;
+    }
+    case 0x1A: { // 0x1A => stack_stat( pid, x )
+      hilevel_stack_stat( ctx );
+      break;
+    }
+    case 0x1B: { // 0x1B => kmem_stat( x )
+      hilevel_kmem_stat( ctx );
+      break;
+    }
+    case 0x1C: { // 0x1C => kmem_leaks()
+      hilevel_kmem_leaks( ctx );
+      break;
+    }
+    case 0x1D: { // 0x1D => sched_rt( period, budget, deadline )
+      hilevel_sched_rt( ctx );
+      break;
+    }
+    case 0x1E: { // 0x1E => rt_misses( pid )
+      hilevel_rt_misses( ctx );
+      break;
+    }
+    case 0x1F: { // 0x1F => group_create( quota, period )
+      hilevel_group_create( ctx );
+      break;
+    }
+    case 0x20: { // 0x20 => group_move( pid, group )
+      hilevel_group_move( ctx );
+      break;
+    }
+    case 0x21: { // 0x21 => futex_wait( x, v )
+      hilevel_futex_wait( ctx );
+      break;
+    }
+    case 0x22: { // 0x22 => futex_wake( x, n )
+      hilevel_futex_wake( ctx );
+      break;
+    }
+    case 0x23: { // 0x23 => shm_create( n )
+      hilevel_shm_create( ctx );
+      break;
+    }
+    case 0x24: { // 0x24 => shm_attach( id )
+      hilevel_shm_attach( ctx );
+      break;
+    }
+    case 0x25: { // 0x25 => shm_detach( id )
+      hilevel_shm_detach( ctx );
+      break;
+    }
+    case 0x26: { // 0x26 => poll( fds, n, timeout )
+      hilevel_poll( ctx );
+      break;
+    }
+    case 0x27: { // 0x27 => chan_open()
+      hilevel_chan_open( ctx );
+      break;
+    }
+    case 0x28: { // 0x28 => chan_close( id )
+      hilevel_chan_close( ctx );
+      break;
+    }
+    case 0x29: { // 0x29 => chan_subscribe( id )
+      hilevel_chan_subscribe( ctx );
+      break;
+    }
+    case 0x2A: { // 0x2A => chan_publish( id, x )
+      hilevel_chan_publish( ctx );
+      break;
+    }
+    case 0x2B: { // 0x2B => chan_read( id, x )
+      hilevel_chan_read( ctx );
+      break;
+    }
+    case 0x2C: { // 0x2C => spawn( x, priority, n, count )
+      hilevel_spawn( ctx );
+      break;
+    }
+    case 0x2D: { // 0x2D => thread_create( f, arg, n )
+      hilevel_thread_create( ctx );
+      break;
+    }
+    case 0x2E: { // 0x2E => thread_join( tid, x )
+      hilevel_thread_join( ctx );
+      break;
+    }
+    case 0x2F: { // 0x2F => uring_setup( x )
+      hilevel_uring_setup( ctx );
+      break;
+    }
+    case 0x30: { // 0x30 => uring_enter()
+      hilevel_uring_enter( ctx );
+      break;
+    }
+    case 0x31: { // 0x31 => futex_wait_pi( x, v )
+      hilevel_futex_wait_pi( ctx );
+      break;
+    }
+    case 0x32: { // 0x32 => waitpid( pid, x, flags )
+      hilevel_waitpid( ctx );
+      break;
+    }
+    case 0x33: { // 0x33 => clock_gettime( id, x )
+      hilevel_clock_gettime( ctx );
+      break;
+    }
+    case 0x34: { // 0x34 => stdio_claim( x )
+      hilevel_outbuf_claim( ctx );
+      break;
+    }
+    case 0x35: { // 0x35 => sched_policy( x )
+      hilevel_sched_policy( ctx );
+      break;
+    }
     default: { // 0x?? => unknown/unsupported
       break;
     }
   }
 
+  kernel_unlock();
+
+  return;
+}
+
+void hilevel_handler_und( ctx_t* ctx ) {
+  /* An undefined instruction is either
+   *
+   * - the first use of the VFP by the current process since another
+   *   process was dispatched, in which case it is retried once the
+   *   VFP is switched to the current process, or
+   * - really undefined, in which case the current process is killed.
+   *
+   * The kernel never uses the VFP, so a trap from anything bar USR mode
+   * is a kernel bug: as per aborts, there is nothing to do but halt.
+   */
+
+  if( ( ctx->cpsr & 0x1F ) != 0x10 ) {
+    while( 1 ) {
+      /* halt */
+    }
+  }
+
+  kernel_lock();
+
+  if( !fpu_trap( get_current_process( pcb_ring ) ) ) {
+    terminate( ctx, EXIT_KILLED | SIG_ILL );
+  }
+
+  kernel_unlock();
+
+  return;
+}
+
+void hilevel_handler_abt( ctx_t* ctx ) {
+  /* A prefetch or data abort is a fault on an access the MMU forbids,
+   * e.g., a write to the clock page or any access to an unmapped
+   * section: the current process is killed, unless the fault is in the
+   * kernel itself, in which case there is nothing sensible to be done
+   * but halt (as per the infinite loop the vector used to be).
+   */
+
+  if( ( ctx->cpsr & 0x1F ) != 0x10 ) {
+    while( 1 ) {
+      /* halt */
+    }
+  }
+
+  kernel_lock();
+
+  terminate( ctx, EXIT_KILLED | SIG_SEGV );
+
+  kernel_unlock();
+
   return;
 }
@@ -1,8 +1,19 @@
 #ifndef __HILEVEL_H
 #define __HILEVEL_H
 
+/* The kernel is built with the same flags as user programs, which may
+ * allow the VFP, but the VFP holds whichever process last used it (see
+ * fpu.h), so code after this point (i.e., all of the kernel) is compiled
+ * as if by -mgeneral-regs-only.
+ */
+
+#ifdef __ARM_FP
+#pragma GCC target ( "general-regs-only" )
+#endif
+
 // Include functionality relating to newlib (the standard C library).
 
+#include <limits.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -14,6 +25,8 @@
 #include   "GIC.h"
 #include "PL011.h"
 #include "SP804.h"
+#include   "PMU.h"
+#include   "VFP.h"
 
 // Include functionality relating to the   kernel.
 
@@ -34,6 +47,20 @@
 #define MAX_PROGS  20
 #define MAX_PIPES  20
 #define STACK_SIZE 0x00005000
+#define SPAWN_MAX  16
+#define SVC_FAST   0x40
+#define OUTBUF_NUM 4
+
+#define THREAD_AGAIN ( -2 )
+#define WAIT_AGAIN   ( -2 )
+
+#define WAIT_NOHANG 0x1
+#define EXIT_KILLED 0x80
+
+#define SIG_ILL  0x02
+#define SIG_SEGV 0x03
+
+#define FUTEX_WAITERS 0x80000000
 
 typedef int pid_t;
 
@@ -46,11 +73,55 @@ typedef enum {
   CLOSED
 } status_t;
 
+typedef struct {
+  uint32_t mask;                    // bit i set iff. counter i is open
+  uint32_t event[ PMU_COUNTERS ];   // event counted by each counter
+  uint32_t count[ PMU_COUNTERS ];   // saved value  of  each counter
+  uint32_t ccnt;                    // saved value  of  cycle counter
+} pmu_ctx_t;
+
+typedef struct {
+  uint32_t period;                  // ticks between releases (0 => not real-time)
+  uint32_t budget;                  // ticks of execution     per release
+  uint32_t deadline;                // ticks after release by which budget is due
+  uint32_t release;                 // tick of current release
+  uint32_t left;                    // ticks of budget left in current release
+  uint32_t misses;                  // releases which missed their deadline
+} rt_t;
+
 typedef struct {
   pid_t pid;
   ctx_t ctx;
   int priority;
   int default_priority;
+  pmu_ctx_t pmu;
+  uint32_t runnable_at;
+  uint32_t stack_tos;
+  uint32_t stack_size;
+  bool stack_overflow;
+  int level;
+  int ticks;
+  rt_t rt;
+  int group;
+  bool throttled;
+  int cpu;
+  bool running;
+  uint32_t wait;
+  uint32_t shm;
+  int poll;
+  int poll_left;
+  bool poll_again;
+  pid_t tgid;
+  pid_t ppid;
+  int status;
+  bool killed;
+  struct uring *uring;
+  pid_t holder;
+  int inherited_priority;
+  int inherited_level;
+  uint32_t fpu[ VFP_WORDS ];
+  bool fpu_used;
+  struct outbuf *outbuf[ OUTBUF_NUM ];
 } pcb_t;
 
 typedef struct {
@@ -62,5 +133,20 @@ typedef struct {
 } pipe_t;
 
 #include "ring.h"
+#include "prof.h"
+#include "clock.h"
+#include "stats.h"
+#include "stack.h"
+#include  "kmem.h"
+#include "sched.h"
+#include   "shm.h"
+#include  "poll.h"
+#include  "chan.h"
+#include "uring.h"
+#include   "fpu.h"
+#include   "mem.h"
+#include    "vm.h"
+#include "outbuf.h"
+#include   "smp.h"
 
 #endif
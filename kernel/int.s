@@ -2,23 +2,28 @@
  * to copy it into place (which is called on reset): note that 
  * 
  * - for interrupts we don't handle an infinite loop is realised (to
- *   to approximate halting the processor), and
+ *   to approximate halting the processor),
  * - we copy the table itself, *plus* the associated addresses stored
  *   as static data: this preserves the relative offset between each 
- *   ldr instruction and wherever it loads from.
+ *   ldr instruction and wherever it loads from, and
+ * - since the table is code, the copy is cleaned from the data cache
+ *   and the instruction cache invalidated afterwards.
  */
 	
 int_data:            ldr   pc, int_addr_rst        @ reset                 vector -> SVC mode
-                     b     .                       @ undefined instruction vector -> UND mode
+                     ldr   pc, int_addr_und        @ undefined instruction vector -> UND mode
                      ldr   pc, int_addr_svc        @ supervisor call       vector -> SVC mode
-                     b     .                       @ pre-fetch abort       vector -> ABT mode
-                     b     .                       @      data abort       vector -> ABT mode
+                     ldr   pc, int_addr_pabt       @ pre-fetch abort       vector -> ABT mode
+                     ldr   pc, int_addr_dabt       @      data abort       vector -> ABT mode
                      b     .                       @ reserved
                      ldr   pc, int_addr_irq        @ IRQ                   vector -> IRQ mode
                      b     .                       @ FIQ                   vector -> FIQ mode
 
 int_addr_rst:        .word lolevel_handler_rst
+int_addr_und:        .word lolevel_handler_und
 int_addr_svc:        .word lolevel_handler_svc
+int_addr_pabt:       .word lolevel_handler_pabt
+int_addr_dabt:       .word lolevel_handler_dabt
 int_addr_irq:        .word lolevel_handler_irq
 	
 .global int_init
@@ -32,8 +37,14 @@ l0:                  ldr   r3, [ r1 ], #4          @ load  word, inc. source
 
                      cmp   r1, r2                  
                      bne   l0                      @ loop if address != limit
+
+                     mov   r12, lr                 @ preserve return address (there may be no stack yet)
+                     mov   r1, r0                  @ set length          = bytes copied
+                     mov   r0, #0                  @ set address         = start of table
+                     bl    mmu_clean_dcache        @ write table back from data cache, then
+                     bl    mmu_inv_icache          @ discard any stale instructions (iff. caches are enabled)
                
-                     mov   pc, lr                  @ return
+                     mov   pc, r12                 @ return
 
 /* These function enable and disable IRQ and FIQ interrupts, toggling
  * either the 6-th or 7-th bit of CPSR to 0 or 1 respectively.
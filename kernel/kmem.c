@@ -0,0 +1,124 @@
+#include "kmem.h"
+
+extern Ring *pipe_ring;
+extern Ring *pcb_ring;
+extern Ring *zombie_ring;
+
+kmem_stat_t kmem;
+kmem_hdr_t *kmem_live;
+
+// account size bytes (which may be negative) against a call site
+void kmem_site(void *site, int size) {
+  for (int i = 0; i < KMEM_SITES; i++) {
+    if (kmem.site[i] == (uint32_t) site || kmem.site[i] == 0) {
+      kmem.site[i]        = (uint32_t) site;
+      kmem.site_bytes[i] += size;
+      return;
+    }
+  }
+
+  // the table is full, so lump any other call site into the last entry
+  kmem.site_bytes[KMEM_SITES - 1] += size;
+}
+
+void *kmalloc(size_t size, uint32_t type, int owner) {
+  kmem_hdr_t *hdr = malloc(sizeof(kmem_hdr_t) + size);
+
+  if (hdr == NULL) {
+    return NULL;
+  }
+
+  hdr->size  = size;
+  hdr->type  = type;
+  hdr->owner = owner;
+  hdr->site  = __builtin_return_address(0);
+
+  hdr->prev = NULL;
+  hdr->next = kmem_live;
+  if (kmem_live != NULL) {
+    kmem_live->prev = hdr;
+  }
+  kmem_live = hdr;
+
+  kmem.allocs[type]++;
+  kmem.bytes[type] += size;
+  kmem.live        += size;
+  if (kmem.live > kmem.peak) {
+    kmem.peak = kmem.live;
+  }
+  kmem_site(hdr->site, size);
+
+  return hdr + 1;
+}
+
+void kfree(void *x) {
+  if (x == NULL) {
+    return;
+  }
+
+  kmem_hdr_t *hdr = (kmem_hdr_t *) x - 1;
+
+  if (hdr->prev != NULL) {
+    hdr->prev->next = hdr->next;
+  } else {
+    kmem_live = hdr->next;
+  }
+  if (hdr->next != NULL) {
+    hdr->next->prev = hdr->prev;
+  }
+
+  kmem.frees[hdr->type]++;
+  kmem.bytes[hdr->type] -= hdr->size;
+  kmem.live             -= hdr->size;
+  kmem_site(hdr->site, -hdr->size);
+
+  free(hdr);
+}
+
+void kmem_copy(kmem_stat_t *x) {
+  memcpy(x, &kmem, sizeof(kmem_stat_t));
+}
+
+// an object has leaked iff. its owning process or pipe no longer exists
+bool kmem_leaked(kmem_hdr_t *hdr) {
+  switch (hdr->type) {
+    case KMEM_PCB: {
+      // an exited thread lives on until joined
+      return get_process_by_id(pcb_ring, hdr->owner) == NULL && get_process_by_id(zombie_ring, hdr->owner) == NULL;
+    }
+    case KMEM_PIPE: {
+      pipe_t *pipe = get_pipe_by_id(pipe_ring, hdr->owner);
+
+      // an open pipe has leaked once neither end remains
+      return pipe == NULL || (get_process_by_id(pcb_ring, pipe->proc1) == NULL &&
+                              get_process_by_id(pcb_ring, pipe->proc2) == NULL);
+    }
+    default: {
+      return false;
+    }
+  }
+}
+
+void kmem_puth32(PL011_t *d, uint32_t x) {
+  PL011_puth(d, (x >> 24) & 0xFF, true);
+  PL011_puth(d, (x >> 16) & 0xFF, true);
+  PL011_puth(d, (x >>  8) & 0xFF, true);
+  PL011_puth(d, (x >>  0) & 0xFF, true);
+}
+
+// each leak is written as one "type owner site size" line of hex words
+int kmem_leaks(PL011_t *d) {
+  int n = 0;
+
+  for (kmem_hdr_t *hdr = kmem_live; hdr != NULL; hdr = hdr->next) {
+    if (kmem_leaked(hdr)) {
+      kmem_puth32(d, hdr->type);             PL011_putc(d, ' ',  true);
+      kmem_puth32(d, hdr->owner);            PL011_putc(d, ' ',  true);
+      kmem_puth32(d, (uint32_t) hdr->site);  PL011_putc(d, ' ',  true);
+      kmem_puth32(d, hdr->size);             PL011_putc(d, '\n', true);
+      n++;
+    }
+  }
+
+  return n;
+}
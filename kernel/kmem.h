@@ -0,0 +1,58 @@
+#ifndef __KMEM_H
+#define __KMEM_H
+
+#include "hilevel.h"
+
+/* Every kernel allocation goes through kmalloc and kfree, which wrap the
+ * newlib allocator st. each object is prefixed by a header recording
+ *
+ * - its type, size and call site (i.e., the caller of kmalloc), plus
+ * - its owner, i.e., the PID of a process object or ID of a pipe,
+ *
+ * and linked into a list of live objects.  This supports accounting by
+ * type and call site, a live bytes and peak gauge, and a leak check st.
+ * objects whose owning process has exited, or whose pipe has closed,
+ * can be reported.  The layout of kmem_stat_t must match libc.h.
+ */
+
+#define KMEM_RING  0
+#define KMEM_NODE  1
+#define KMEM_CTX   2
+#define KMEM_PCB   3
+#define KMEM_PIPE  4
+
+#define KMEM_TYPES 5
+#define KMEM_SITES 16
+
+typedef struct kmem_hdr {
+  struct kmem_hdr *next;
+  struct kmem_hdr *prev;
+  uint32_t size;
+  uint32_t type;
+  int      owner;
+  void    *site;
+} kmem_hdr_t;
+
+typedef struct {
+  uint32_t live;                     // bytes currently allocated
+  uint32_t peak;                     // maximum of live since reset
+  uint32_t allocs[ KMEM_TYPES ];     // allocations per type
+  uint32_t frees[ KMEM_TYPES ];      // frees       per type
+  uint32_t bytes[ KMEM_TYPES ];      // live bytes  per type
+  uint32_t site[ KMEM_SITES ];       // call site address
+  uint32_t site_bytes[ KMEM_SITES ]; // live bytes  per call site
+} kmem_stat_t;
+
+// Allocate size bytes for an object of the given type and owner.
+void *kmalloc(size_t size, uint32_t type, int owner);
+
+// Free an object allocated by kmalloc; NULL is ignored.
+void kfree(void *x);
+
+// Copy the allocation statistics into x.
+void kmem_copy(kmem_stat_t *x);
+
+// Write each leaked object to the UART, and return how many there are.
+int kmem_leaks(PL011_t *d);
+
+#endif
@@ -6,11 +6,32 @@
 .global lolevel_handler_rst
 .global lolevel_handler_irq
 .global lolevel_handler_svc
+.global lolevel_handler_smp
+.global lolevel_handler_und
+.global lolevel_handler_pabt
+.global lolevel_handler_dabt
 
-lolevel_handler_rst: bl    int_init                @ initialise interrupt vector table
+lolevel_handler_rst: mrc   p15, 0, r4, c0, c0, 5   @ read  MPIDR
+                     tst   r4, #0x80000000         @ multi-core format, i.e., MPCore?
+                     beq   rst_boot                @ no  => single core, so boot
+                     ands  r4, r4, #0x3            @ extract CPU ID
+                     beq   rst_boot                @ 0   => boot core,   so boot
+
+                     ldr   r5, =0x10000030         @ otherwise, get address of system flags
+rst_park:            wfe                           @ wait  for an event, i.e., smp_boot
+                     ldr   r6, [ r5 ]              @ load  entry point from system flags
+                     cmp   r6, #0
+                     beq   rst_park                @ loop  until there is one
+                     bx    r6                      @ jump  to entry point
+
+rst_boot:            bl    int_init                @ initialise interrupt vector table
 
                      msr   cpsr, #0xD2             @ enter IRQ mode with IRQ and FIQ interrupts disabled
                      ldr   sp, =tos_irq            @ initialise IRQ mode stack
+                     msr   cpsr, #0xDB             @ enter UND mode with IRQ and FIQ interrupts disabled
+                     ldr   sp, =tos_und            @ initialise UND mode stack
+                     msr   cpsr, #0xD7             @ enter ABT mode with IRQ and FIQ interrupts disabled
+                     ldr   sp, =tos_abt            @ initialise ABT mode stack
                      msr   cpsr, #0xD3             @ enter SVC mode with IRQ and FIQ interrupts disabled
                      ldr   sp, =tos_svc            @ initialise SVC mode stack
 
@@ -24,6 +45,36 @@ lolevel_handler_rst: bl    int_init                @ initialise interrupt vector
                      msr   spsr, r0                @ set    USR mode        CPSR
                      ldmia sp, { r0-r12, sp, lr }^ @ load   USR mode registers
                      add   sp, sp, #60             @ update SVC mode SP
+                     clrex                         @ clear  exclusive monitor, st. any interrupted ldrex/strex retries
+                     movs  pc, lr                  @ return from interrupt
+
+lolevel_handler_smp: mrc   p15, 0, r4, c0, c0, 5   @ read  MPIDR
+                     and   r4, r4, #0x3            @ extract CPU ID
+
+                     msr   cpsr, #0xD2             @ enter IRQ mode with IRQ and FIQ interrupts disabled
+                     ldr   sp, =tos_irq            @ initialise IRQ mode stack
+                     sub   sp, sp, r4, lsl #12     @        ... offset by 0x1000 per CPU
+                     msr   cpsr, #0xDB             @ enter UND mode with IRQ and FIQ interrupts disabled
+                     ldr   sp, =tos_und            @ initialise UND mode stack
+                     sub   sp, sp, r4, lsl #12     @        ... offset by 0x1000 per CPU
+                     msr   cpsr, #0xD7             @ enter ABT mode with IRQ and FIQ interrupts disabled
+                     ldr   sp, =tos_abt            @ initialise ABT mode stack
+                     sub   sp, sp, r4, lsl #12     @        ... offset by 0x1000 per CPU
+                     msr   cpsr, #0xD3             @ enter SVC mode with IRQ and FIQ interrupts disabled
+                     ldr   sp, =tos_svc            @ initialise SVC mode stack
+                     sub   sp, sp, r4, lsl #12     @        ... offset by 0x1000 per CPU
+
+                     sub   sp, sp, #68             @ initialise dummy context
+
+                     mov   r0, sp                  @ set    high-level C function arg. = SP
+
+                     bl    hilevel_handler_smp     @ invoke high-level C function
+
+                     ldmia sp!, { r0, lr }         @ load   USR mode PC and CPSR
+                     msr   spsr, r0                @ set    USR mode        CPSR
+                     ldmia sp, { r0-r12, sp, lr }^ @ load   USR mode registers
+                     add   sp, sp, #60             @ update SVC mode SP
+                     clrex                         @ clear  exclusive monitor, st. any interrupted ldrex/strex retries
                      movs  pc, lr                  @ return from interrupt
 
 lolevel_handler_irq: sub   lr, lr, #4              @ correct return address
@@ -40,9 +91,77 @@ lolevel_handler_irq: sub   lr, lr, #4              @ correct return address
                      msr   spsr, r0                @ set    USR mode        CPSR
                      ldmia sp, { r0-r12, sp, lr }^ @ load   USR mode registers
                      add   sp, sp, #60             @ update SVC mode SP
+                     clrex                         @ clear  exclusive monitor, st. any interrupted ldrex/strex retries
+                     movs  pc, lr                  @ return from interrupt
+
+lolevel_handler_und: sub   lr, lr, #4              @ correct return address, to retry instruction
+                     sub   sp, sp, #60             @ update UND mode stack     sp = sp - 60
+                     stmia sp, { r0-r12, sp, lr }^ @ store  USR registers
+                     mrs   r0, spsr                @ get    USR        CPSR
+                     stmdb sp!, { r0, lr }         @ store  USR PC and CPSR
+
+                     mov   r0, sp                  @ set    high-level C function arg. = SP
+
+                     bl    hilevel_handler_und     @ invoke high-level C function
+
+                     ldmia sp!, { r0, lr }         @ load   USR mode PC and CPSR
+                     msr   spsr, r0                @ set    USR mode        CPSR
+                     ldmia sp, { r0-r12, sp, lr }^ @ load   USR mode registers
+                     add   sp, sp, #60             @ update UND mode SP
+                     clrex                         @ clear  exclusive monitor, st. any interrupted ldrex/strex retries
+                     movs  pc, lr                  @ return from interrupt
+
+lolevel_handler_pabt: sub  lr, lr, #4              @ correct return address, to the faulting instruction
+                     b     lolevel_handler_abt
+
+lolevel_handler_dabt: sub  lr, lr, #8              @ correct return address, to the faulting instruction
+
+lolevel_handler_abt: sub   sp, sp, #60             @ update ABT mode stack     sp = sp - 60
+                     stmia sp, { r0-r12, sp, lr }^ @ store  USR registers
+                     mrs   r0, spsr                @ get    USR        CPSR
+                     stmdb sp!, { r0, lr }         @ store  USR PC and CPSR
+
+                     mov   r0, sp                  @ set    high-level C function arg. = SP
+
+                     bl    hilevel_handler_abt     @ invoke high-level C function
+
+                     ldmia sp!, { r0, lr }         @ load   USR mode PC and CPSR
+                     msr   spsr, r0                @ set    USR mode        CPSR
+                     ldmia sp, { r0-r12, sp, lr }^ @ load   USR mode registers
+                     add   sp, sp, #60             @ update ABT mode SP
+                     clrex                         @ clear  exclusive monitor, st. any interrupted ldrex/strex retries
                      movs  pc, lr                  @ return from interrupt
 
-lolevel_handler_svc: sub   lr, lr, #0              @ correct return address    lr = lr - 0
+/* System calls in the svc_fast jump table neither block nor reschedule,
+ * so they take a fast path which preserves only the caller-saved USR
+ * registers (the high-level C function preserves the rest); the full
+ * context is saved only for other calls, or iff. the fast path declines.
+ */
+
+lolevel_handler_svc: stmdb sp!, { r0-r3, r12, lr } @ store  USR caller-saved registers
+                     mrs   r0, spsr                @ get    USR        CPSR
+                     stmdb sp!, { r0, lr }         @ store  USR PC and CPSR
+
+                     ldr   r1, [ lr, #-4 ]         @ load                     svc instruction
+                     bic   r1, r1, #0xFF000000     @ set    high-level C function arg. = svc immediate
+                     cmp   r1, #0x40               @ if     svc immediate < SVC_FAST
+                     ldrlo r0, =svc_fast           @ then   load fast path handler from jump table
+                     ldrlo r0, [ r0, r1, lsl #2 ]
+                     movhs r0, #0                  @ else   there is no fast path handler
+                     cmp   r0, #0
+                     addeq sp, sp, #8              @ discard USR PC and CPSR
+                     beq   lolevel_handler_svc_full
+
+                     mov   r0, sp                  @ set    high-level C function arg. = SP
+                     bl    hilevel_handler_fast    @ invoke high-level C function
+
+                     add   sp, sp, #8              @ discard USR PC and CPSR
+                     clrex                         @ clear  exclusive monitor, st. any interrupted ldrex/strex retries
+                     cmp   r0, #0
+                     ldmneia sp!, { r0-r3, r12, pc }^ @ return from interrupt, iff. handled
+
+lolevel_handler_svc_full:
+                     ldmia sp!, { r0-r3, r12, lr } @ load   USR caller-saved registers
                      sub   sp, sp, #60             @ update SVC mode stack     sp = sp - 60
                      stmia sp, { r0-r12, sp, lr }^ @ store  USR registers
                      mrs   r0, spsr                @ get    USR        CPSR
@@ -58,4 +177,5 @@ lolevel_handler_svc: sub   lr, lr, #0              @ correct return address    l
                      msr   spsr, r0                @ set    USR mode        CPSR
                      ldmia sp, { r0-r12, sp, lr }^ @ load   USR mode registers
                      add   sp, sp, #60             @ update SVC mode SP
+                     clrex                         @ clear  exclusive monitor, st. any interrupted ldrex/strex retries
                      movs  pc, lr                  @ return from interrupt
@@ -0,0 +1,14 @@
+#ifndef __MEM_H
+#define __MEM_H
+
+#include "hilevel.h"
+
+/* mem.s replaces memcpy, memset and memcmp (as declared by string.h)
+ * with versions which move words in bursts, and adds a fixed-size copy
+ * for the context saved and restored on each switch.
+ */
+
+// Copy the execution context src into dst, i.e., memcpy of sizeof(ctx_t).
+void ctx_copy(ctx_t *dst, const ctx_t *src);
+
+#endif
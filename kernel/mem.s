@@ -0,0 +1,125 @@
+/* The following functions replace the generic, byte-at-a-time versions
+ * of memcpy, memset and memcmp in newlib (since an object file linked
+ * explicitly takes precedence over an archive member): each moves whole
+ * words once the addresses allow, in bursts of 8 words via ldm and stm
+ * for memcpy and memset, so handles any tail by word then by byte.
+ * ctx_copy is the fixed-size case of memcpy for a ctx_t, i.e., 17 words
+ * in 2 bursts.  NEON would move 16 bytes per instruction, but the VFP
+ * register file belongs to whichever user process owns it (see fpu.h),
+ * so the kernel avoids it altogether.
+ */
+
+.global memcpy
+.global memset
+.global memcmp
+
+.global ctx_copy
+
+.type   memcpy,   %function
+.type   memset,   %function
+.type   memcmp,   %function
+.type   ctx_copy, %function
+
+memcpy:              push  { r0, r4-r10, lr }      @ preserve dst (the return value), callee-saved registers
+                     eor   r3, r0, r1
+                     tst   r3, #3                  @ if     dst and src differ in alignment
+                     bne   memcpy_byte             @ then   copy byte by byte
+
+memcpy_align:        tst   r0, #3                  @ copy bytes until dst (and so src) is word-aligned
+                     beq   memcpy_words
+                     subs  r2, r2, #1
+                     blo   memcpy_done
+                     ldrb  r3, [ r1 ], #1
+                     strb  r3, [ r0 ], #1
+                     b     memcpy_align
+
+memcpy_words:        subs  r2, r2, #32
+                     blo   memcpy_word_tail
+memcpy_burst:        ldmia r1!, { r3-r10 }         @ load  8 words
+                     stmia r0!, { r3-r10 }         @ store 8 words
+                     subs  r2, r2, #32
+                     bhs   memcpy_burst
+memcpy_word_tail:    adds  r2, r2, #28             @ copy remaining words one at a time
+memcpy_word:         ldrhs r3, [ r1 ], #4
+                     strhs r3, [ r0 ], #4
+                     subhss r2, r2, #4
+                     bhs   memcpy_word
+                     add   r2, r2, #4
+
+memcpy_byte:         subs  r2, r2, #1              @ copy remaining bytes one at a time
+                     ldrhsb r3, [ r1 ], #1
+                     strhsb r3, [ r0 ], #1
+                     bhs   memcpy_byte
+
+memcpy_done:         pop   { r0, r4-r10, pc }      @ return dst
+
+memset:              push  { r0, r4-r9, lr }       @ preserve s (the return value), callee-saved registers
+                     and   r1, r1, #0xFF           @ replicate byte c into every byte of a word
+                     orr   r1, r1, r1, lsl #8
+                     orr   r1, r1, r1, lsl #16
+
+memset_align:        tst   r0, #3                  @ set bytes until s is word-aligned
+                     beq   memset_words
+                     subs  r2, r2, #1
+                     blo   memset_done
+                     strb  r1, [ r0 ], #1
+                     b     memset_align
+
+memset_words:        mov   r3, r1
+                     mov   r4, r1
+                     mov   r5, r1
+                     mov   r6, r1
+                     mov   r7, r1
+                     mov   r8, r1
+                     mov   r9, r1
+                     subs  r2, r2, #32
+                     blo   memset_word_tail
+memset_burst:        stmia r0!, { r1, r3-r9 }      @ store 8 words
+                     subs  r2, r2, #32
+                     bhs   memset_burst
+memset_word_tail:    adds  r2, r2, #28             @ set remaining words one at a time
+memset_word:         strhs r1, [ r0 ], #4
+                     subhss r2, r2, #4
+                     bhs   memset_word
+                     add   r2, r2, #4
+
+memset_byte:         subs  r2, r2, #1              @ set remaining bytes one at a time
+                     strhsb r1, [ r0 ], #1
+                     bhs   memset_byte
+
+memset_done:         pop   { r0, r4-r9, pc }       @ return s
+
+memcmp:              push  { r4, lr }
+                     orr   r3, r0, r1
+                     tst   r3, #3                  @ if     x or y is not word-aligned
+                     bne   memcmp_byte             @ then   compare byte by byte
+
+memcmp_word:         subs  r2, r2, #4              @ compare words until a pair differs
+                     blo   memcmp_word_tail
+                     ldr   r3, [ r0 ], #4
+                     ldr   r4, [ r1 ], #4
+                     cmp   r3, r4
+                     beq   memcmp_word
+                     sub   r0, r0, #4              @ rewind, st. the bytes of the pair are compared
+                     sub   r1, r1, #4
+memcmp_word_tail:    add   r2, r2, #4
+
+memcmp_byte:         subs  r2, r2, #1              @ compare bytes until a pair differs
+                     movlo r0, #0
+                     blo   memcmp_done
+                     ldrb  r3, [ r0 ], #1
+                     ldrb  r4, [ r1 ], #1
+                     cmp   r3, r4
+                     beq   memcmp_byte
+                     sub   r0, r3, r4              @ return difference of first differing bytes
+
+memcmp_done:         pop   { r4, pc }
+
+ctx_copy:            push  { r4-r10 }
+                     ldmia r1!, { r2-r10 }         @ load  cpsr, pc, gpr[ 0 ] to gpr[ 6 ]
+                     stmia r0!, { r2-r10 }         @ store cpsr, pc, gpr[ 0 ] to gpr[ 6 ]
+                     ldmia r1,  { r2-r9  }         @ load  gpr[ 7 ] to gpr[ 12 ], sp, lr
+                     stmia r0,  { r2-r9  }         @ store gpr[ 7 ] to gpr[ 12 ], sp, lr
+                     pop   { r4-r10 }
+
+                     mov   pc, lr                  @ return
@@ -0,0 +1,36 @@
+#include "outbuf.h"
+
+int outbuf_claim(pcb_t *pcb, outbuf_t *x) {
+  for (int i = 0; i < OUTBUF_NUM; i++) {
+    if (pcb->outbuf[i] == x) {
+      return 0;
+    }
+  }
+
+  for (int i = 0; i < OUTBUF_NUM; i++) {
+    if (pcb->outbuf[i] == NULL) {
+      pcb->outbuf[i] = x;
+      return 0;
+    }
+  }
+
+  return -1;
+}
+
+void outbuf_exit(pcb_t *pcb) {
+  for (int i = 0; i < OUTBUF_NUM; i++) {
+    outbuf_t *x = pcb->outbuf[i];
+
+    // exit releases the buffer itself, after which another process may own it
+    if (x != NULL && x->pid == pcb->pid) {
+      for (int j = 0; j < x->n && j < OUTBUF_SIZE; j++) {
+        PL011_putc(UART0, x->buf[j], true);
+      }
+
+      x->n   = 0;
+      x->pid = 0;
+    }
+
+    pcb->outbuf[i] = NULL;
+  }
+}
@@ -0,0 +1,27 @@
+#ifndef __OUTBUF_H
+#define __OUTBUF_H
+
+#include "hilevel.h"
+
+/* libc buffers output per process (see stdio_buf_t in libc.h), and
+ * registers each buffer it claims (up to OUTBUF_NUM) with the kernel: a process which is
+ * killed, rather than calling exit, has the kernel flush then release
+ * its buffers, st. no output is lost and no buffer is leaked, nor left
+ * for a later process with the same PID.  The layout must match libc.h.
+ */
+
+#define OUTBUF_SIZE  128
+
+typedef struct outbuf {
+  volatile pid_t pid;               // owner (0 => unused)
+  int            n;                 // bytes buffered
+  char           buf[ OUTBUF_SIZE ];
+} outbuf_t;
+
+// Register a buffer claimed by the process; return 0 iff. success.
+int  outbuf_claim(pcb_t *pcb, outbuf_t *x);
+
+// Flush then release any buffer the process still owns, as it exits.
+void outbuf_exit(pcb_t *pcb);
+
+#endif
@@ -0,0 +1,96 @@
+#include "poll.h"
+
+extern Ring *pcb_ring;
+extern Ring *pipe_ring;
+
+int poll_events(pollfd_t *fd) {
+  if (fd->fd == POLL_CONSOLE) {
+    return (PL011_can_getc(UART1) ? POLL_IN  : 0) |
+           (PL011_can_putc(UART1) ? POLL_OUT : 0);
+  }
+
+  pipe_t *pipe = get_pipe_by_id(pipe_ring, fd->fd);
+
+  if (pipe == NULL) {
+    return POLL_ERR;
+  }
+
+  return (pipe->value != -1 ? POLL_IN : POLL_OUT);
+}
+
+int poll_scan(pollfd_t *fds, int n) {
+  int r = 0;
+
+  for (int i = 0; i < n; i++) {
+    // errors are reported whether or not they were asked for
+    fds[i].revents = poll_events(&fds[i]) & (fds[i].events | POLL_ERR);
+
+    if (fds[i].revents != 0) {
+      r++;
+    }
+  }
+
+  return r;
+}
+
+// a process waiting on a single pipe waits for whoever is at the other end
+pid_t poll_holder(pcb_t *pcb, pollfd_t *fds, int n) {
+  pipe_t *pipe = (n == 1 && fds[0].fd != POLL_CONSOLE) ? get_pipe_by_id(pipe_ring, fds[0].fd) : NULL;
+
+  if (pipe == NULL) {
+    return 0;
+  }
+  else if (pipe->proc1 == pcb->pid) {
+    return pipe->proc2;
+  }
+  else if (pipe->proc2 == pcb->pid) {
+    return pipe->proc1;
+  }
+
+  return 0;
+}
+
+void poll_block(pcb_t *pcb, pollfd_t *fds, int n, int timeout) {
+  pcb->wait      = (uint32_t) fds;
+  pcb->poll      = n;
+  pcb->poll_left = timeout;
+  pcb->holder    = poll_holder(pcb, fds, n);
+  sched_throttle(pcb);
+
+  // the receive interrupt is masked once taken, so unmask it for this wait
+  for (int i = 0; i < n; i++) {
+    if (fds[i].fd == POLL_CONSOLE && (fds[i].events & POLL_IN)) {
+      UART1->IMSC |= 0x00000010;
+    }
+  }
+}
+
+void poll_wake(bool tick) {
+  for (Node *node = pcb_ring->first->next; !is_sentinel(node); node = node->next) {
+    pcb_t *pcb = (pcb_t*)node->item;
+
+    if (pcb->poll == 0) {
+      continue;
+    }
+
+    if (tick && pcb->poll_left > 0) {
+      pcb->poll_left--;
+    }
+
+    int r = poll_scan((pollfd_t *) pcb->wait, pcb->poll);
+
+    if (r == 0 && pcb->poll_left != 0) {
+      continue;
+    }
+
+    // the process is not running, so return via its saved context
+    pcb->ctx.gpr[0] = r;
+    pcb->wait       = 0;
+    pcb->poll       = 0;
+    sched_throttle(pcb);
+
+    if (pcb->cpu != cpu_id()) {
+      smp_kick(pcb->cpu);
+    }
+  }
+}
@@ -0,0 +1,46 @@
+#ifndef __POLL_H
+#define __POLL_H
+
+#include "hilevel.h"
+
+/* A process may wait for any of several pipes, or the console UART, to
+ * become ready: a descriptor is either a pipe id (which start at 1) or
+ * POLL_CONSOLE, i.e., UART1.  A pipe is readable iff. it holds a value,
+ * and writable iff. it is empty; the UART is readable iff. its receive
+ * FIFO is non-empty, and writable iff. its transmit FIFO is not full.
+ *
+ * A process which finds nothing ready blocks (as with futex_wait), and
+ * is re-checked whenever a pipe changes, the UART receives, or the timer
+ * ticks, the latter also counting down its timeout.  If it is instead
+ * dispatched spuriously (i.e., while blocked), it gets POLL_AGAIN and
+ * polls again, resuming whatever is left of its timeout, st. 0 is only
+ * ever returned once the timeout has elapsed.  The layout of pollfd_t
+ * must match libc.h.
+ */
+
+#define POLL_CONSOLE 0
+
+#define POLL_IN      0x01           // readable
+#define POLL_OUT     0x02           // writable
+#define POLL_ERR     0x04           // no such pipe
+
+#define POLL_AGAIN   ( -2 )         // woken up spuriously, so poll again
+
+typedef struct {
+  int fd;                           // pipe id, or POLL_CONSOLE
+  int events;                       // POLL_IN and/or POLL_OUT
+  int revents;                      // events ready, or POLL_ERR
+} pollfd_t;
+
+// Fill in the ready events of each descriptor; return how many are ready.
+int  poll_scan(pollfd_t *fds, int n);
+
+// Block the process until a descriptor is ready, or timeout ticks (< 0 =>
+// never) pass.
+void poll_block(pcb_t *pcb, pollfd_t *fds, int n, int timeout);
+
+// Re-check each blocked process, waking those with a descriptor ready or
+// whose timeout expired; tick is true iff. invoked by the timer.
+void poll_wake(bool tick);
+
+#endif
@@ -0,0 +1,68 @@
+#include "prof.h"
+
+prof_entry_t prof_table[PROF_BUCKETS];
+uint32_t     prof_dropped;
+
+void prof_start(uint32_t period) {
+  memset(prof_table, 0, sizeof(prof_table));
+  prof_dropped = 0;
+
+  TIMER1->Timer1Load  = period;     // select sampling period
+  TIMER1->Timer1Ctrl  = 0x00000002; // select 32-bit   timer
+  TIMER1->Timer1Ctrl |= 0x00000040; // select periodic timer
+  TIMER1->Timer1Ctrl |= 0x00000020; // enable          timer interrupt
+  TIMER1->Timer1Ctrl |= 0x00000080; // enable          timer
+}
+
+void prof_stop() {
+  TIMER1->Timer1Ctrl &= ~0x00000080; // disable        timer
+}
+
+void prof_sample(pid_t pid, uint32_t pc) {
+  uint32_t hash = ((pc >> 2) ^ ((uint32_t) pid * 0x9E3779B1)) & (PROF_BUCKETS - 1);
+
+  for (int i = 0; i < PROF_PROBES; i++) {
+    prof_entry_t *entry = &prof_table[(hash + i) & (PROF_BUCKETS - 1)];
+
+    if (entry->count == 0) {
+      entry->pid = pid;
+      entry->pc  = pc;
+    }
+    if (entry->pid == pid && entry->pc == pc) {
+      entry->count++;
+      return;
+    }
+  }
+
+  prof_dropped++;
+}
+
+void prof_puth32(PL011_t *d, uint32_t x) {
+  PL011_puth(d, (x >> 24) & 0xFF, true);
+  PL011_puth(d, (x >> 16) & 0xFF, true);
+  PL011_puth(d, (x >>  8) & 0xFF, true);
+  PL011_puth(d, (x >>  0) & 0xFF, true);
+}
+
+void prof_puts(PL011_t *d, char *x) {
+  while (*x != '\x00') {
+    PL011_putc(d, *x++, true);
+  }
+}
+
+// each entry is written as one "pid pc count" line of hex words
+void prof_dump(PL011_t *d) {
+  prof_puts(d, "\nprof: begin\n");
+
+  for (int i = 0; i < PROF_BUCKETS; i++) {
+    if (prof_table[i].count != 0) {
+      prof_puth32(d, prof_table[i].pid);   PL011_putc(d, ' ',  true);
+      prof_puth32(d, prof_table[i].pc);    PL011_putc(d, ' ',  true);
+      prof_puth32(d, prof_table[i].count); PL011_putc(d, '\n', true);
+    }
+  }
+
+  prof_puts(d, "prof: dropped ");
+  prof_puth32(d, prof_dropped);
+  prof_puts(d, "\nprof: end\n");
+}
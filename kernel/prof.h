@@ -0,0 +1,33 @@
+#ifndef __PROF_H
+#define __PROF_H
+
+#include "hilevel.h"
+
+/* The profiler samples the interrupted PC (plus current PID) each time
+ * the profiling timer fires, and accumulates a histogram keyed on the
+ * (pid, pc) pair in a fixed-size, open-addressed hash table: samples
+ * which cannot be placed once the table is full are only counted.
+ */
+
+#define PROF_BUCKETS 1024
+#define PROF_PROBES     8
+
+typedef struct {
+  pid_t    pid;
+  uint32_t pc;
+  uint32_t count;
+} prof_entry_t;
+
+// Start sampling every period ticks of the profiling timer, clearing the histogram.
+void prof_start(uint32_t period);
+
+// Stop sampling, leaving the histogram intact.
+void prof_stop();
+
+// Record one sample of the given process interrupted at the given pc.
+void prof_sample(pid_t pid, uint32_t pc);
+
+// Write the histogram to the UART in the format read by prof.py.
+void prof_dump(PL011_t *d);
+
+#endif
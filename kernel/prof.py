@@ -0,0 +1,102 @@
+import argparse, bisect, collections, subprocess, sys
+
+# The kernel dumps its PC histogram as a block of lines, each of which
+# is a "pid pc count" triple of 32-bit hex words, between begin and end
+# markers: anything else captured from the UART is ignored.
+
+def parse( lines ) :
+  samples = [] ; dropped = 0 ; active = False
+
+  for line in lines :
+    line = line.strip()
+
+    if   ( line == 'prof: begin' ) :
+      samples = [] ; active = True
+    elif ( line == 'prof: end'   ) :
+      active = False
+    elif ( line.startswith( 'prof: dropped ' ) ) :
+      dropped = int( line.split( ' ' )[ 2 ], 16 )
+    elif ( active ) :
+      fields = line.split( ' ' )
+
+      if ( len( fields ) == 3 ) :
+        samples.append( tuple( [ int( x, 16 ) for x in fields ] ) )
+
+  return ( samples, dropped )
+
+# Function symbols are read (sorted by address) via nm, st. each PC can
+# be mapped to the closest symbol at or below it by bisection.
+
+def symbols( nm, elf ) :
+  addrs = [] ; names = []
+
+  for line in subprocess.check_output( [ nm, '-n', elf ] ).decode().splitlines() :
+    fields = line.split()
+
+    if ( len( fields ) == 3 and fields[ 1 ] in 'tTwW' ) :
+      addrs.append( int( fields[ 0 ], 16 ) ) ; names.append( fields[ 2 ] )
+
+  return ( addrs, names )
+
+def symbolize( addrs, names, pc ) :
+  i = bisect.bisect_right( addrs, pc ) - 1
+
+  if ( i < 0 ) :
+    return '0x%08X' % ( pc )
+
+  return names[ i ]
+
+def lines( addr2line, elf, pcs ) :
+  out = subprocess.check_output( [ addr2line, '-e', elf ] + [ '0x%X' % ( pc ) for pc in pcs ] ).decode().splitlines()
+
+  return dict( zip( pcs, out ) )
+
+# The command line interface reads a UART capture, then prints a flat
+# profile (samples per function, most frequent first) for each PID.
+
+if ( __name__ == '__main__' ) :
+  # parse command line arguments
+
+  parser = argparse.ArgumentParser()
+
+  parser.add_argument( '--file',      type = str, action = 'store'                                  )
+  parser.add_argument( '--elf',       type = str, action = 'store'                                  )
+  parser.add_argument( '--nm',        type = str, action = 'store', default = 'arm-none-eabi-nm'        )
+  parser.add_argument( '--addr2line', type = str, action = 'store', default = 'arm-none-eabi-addr2line' )
+
+  parser.add_argument( '--lines',                 action = 'store_true'                             )
+
+  args = parser.parse_args()
+
+  # read and symbolize samples
+
+  with open( args.file, 'r' ) as f :
+    ( samples, dropped ) = parse( f )
+
+  ( addrs, names ) = symbols( args.nm, args.elf )
+
+  if ( args.lines ) :
+    where = lines( args.addr2line, args.elf, sorted( set( [ pc for ( pid, pc, n ) in samples ] ) ) )
+  else :
+    where = None
+
+  profile = collections.defaultdict( collections.Counter )
+
+  for ( pid, pc, n ) in samples :
+    if ( where != None ) :
+      profile[ pid ][ symbolize( addrs, names, pc ) + ' (' + where[ pc ] + ')' ] += n
+    else :
+      profile[ pid ][ symbolize( addrs, names, pc )                            ] += n
+
+  # write flat profile per process
+
+  for pid in sorted( profile.keys() ) :
+    total = sum( profile[ pid ].values() )
+
+    print( 'pid %d : %d samples' % ( pid, total ) )
+
+    for ( name, n ) in profile[ pid ].most_common() :
+      print( '  %6.2f%% %8d  %s' % ( 100.0 * n / total, n, name ) )
+
+  if ( dropped > 0 ) :
+    print( 'dropped %d samples (histogram full)' % ( dropped ) )
@@ -35,7 +35,7 @@ void move_back(Ring *ring) {
 }
 
 Node *create_node(void *item, Node *next_node, Node *prev_node) {
-  Node *new_node = malloc(sizeof(Node));
+  Node *new_node = kmalloc(sizeof(Node), KMEM_NODE, 0);
   new_node->next = next_node;
   new_node->prev = prev_node;
   new_node->item = item;
@@ -56,7 +56,7 @@ void insert_after(Ring *ring, void *item) {
 }
 
 Ring *create_ring() {
-  Ring *new_ring = malloc(sizeof(Ring));
+  Ring *new_ring = kmalloc(sizeof(Ring), KMEM_RING, 0);
 
   Node *sentinel_node = create_node(NULL, NULL, NULL);
   sentinel_node->next = sentinel_node;
@@ -92,8 +92,8 @@ void delete(Ring *ring) {
     ring->current->next->prev = ring->current->prev;
     ring->current->prev->next = ring->current->next;
     old_current = ring->current;
-    free(ring->current);
     ring->current = old_current->prev;
+    kfree(old_current);
   }
 }
 
@@ -118,6 +118,28 @@ int locate_by_id(Ring *ring, pid_t id) {
   return 0;
 }
 
+int locate_by_tgid(Ring *ring, pid_t id) {
+  set_last(ring);
+  while (!is_sentinel(ring->current)) {
+    if (((pcb_t*)ring->current->item)->tgid == id) {
+      return 1;
+    }
+    move_back(ring);
+  }
+  return 0;
+}
+
+int locate_by_ppid(Ring *ring, pid_t id) {
+  set_last(ring);
+  while (!is_sentinel(ring->current)) {
+    if (((pcb_t*)ring->current->item)->ppid == id) {
+      return 1;
+    }
+    move_back(ring);
+  }
+  return 0;
+}
+
 int locate_by_pipe_id(Ring *ring, pid_t id) {
   set_last(ring);
   while (!is_sentinel(ring->current)) {
@@ -129,6 +151,28 @@ int locate_by_pipe_id(Ring *ring, pid_t id) {
   return 0;
 }
 
+pcb_t *get_process_by_id(Ring *ring, pid_t id) {
+  Node *node = ring->first->next;
+  while (!is_sentinel(node)) {
+    if (((pcb_t*)node->item)->pid == id) {
+      return (pcb_t*)node->item;
+    }
+    node = node->next;
+  }
+  return NULL;
+}
+
+pipe_t *get_pipe_by_id(Ring *ring, pid_t id) {
+  Node *node = ring->first->next;
+  while (!is_sentinel(node)) {
+    if (((pipe_t*)node->item)->pid == id) {
+      return (pipe_t*)node->item;
+    }
+    node = node->next;
+  }
+  return NULL;
+}
+
 void move_to_end(Ring *ring) {
   Node *node_to_be_moved = ring->current;
   delete(ring);
@@ -159,19 +203,117 @@ int get_current_pos_in_ring(Ring *ring) {
   return length;
 }
 
+// a pcb is eligible iff. it is homed on this core, not running on another,
+// and not being terminated
+bool is_eligible(Ring *ring, Node *node) {
+  pcb_t *pcb = (pcb_t*)node->item;
+  return pcb->cpu == cpu_id() && (!pcb->running || node == ring->current) && !pcb->killed;
+}
+
+// a throttled pcb is only ever better than another throttled pcb
+bool is_throttled_worse(Node *node, Node *best) {
+  return ((pcb_t*)node->item)->throttled && !((pcb_t*)best->item)->throttled;
+}
+
+bool is_throttled_better(Node *node, Node *best) {
+  return !((pcb_t*)node->item)->throttled && ((pcb_t*)best->item)->throttled;
+}
+
+// a pcb runs with the better of its own priority (or level) and that it inherited
+int effective_priority(Node *node) {
+  pcb_t *pcb = (pcb_t*)node->item;
+  return (pcb->inherited_priority > pcb->priority) ? pcb->inherited_priority : pcb->priority;
+}
+
+int effective_level(Node *node) {
+  pcb_t *pcb = (pcb_t*)node->item;
+  return (pcb->inherited_level < pcb->level) ? pcb->inherited_level : pcb->level;
+}
+
+bool is_better_priority(Node *node, Node *best) {
+  if (best == NULL || is_throttled_better(node, best)) {
+    return true;
+  }
+  return !is_throttled_worse(node, best) && effective_priority(node) > effective_priority(best);
+}
+
+bool is_better_level(Node *node, Node *best) {
+  if (best == NULL || is_throttled_better(node, best)) {
+    return true;
+  }
+  return !is_throttled_worse(node, best) && effective_level(node) < effective_level(best);
+}
+
+// scan from the pcb after current, wrapping round st. current comes last
 void locate_highest_priority(Ring *ring) {
-  set_first(ring);
-  int max_priority = 0;
-  pid_t max_priority_pid = 0;
-  while (!is_sentinel(ring->current)) {
-    if (((pcb_t*)ring->current->item)->priority >= max_priority) {
-      max_priority = ((pcb_t*)ring->current->item)->priority;
-      max_priority_pid = get_current_pid(ring);
+  Node *start = ring->current;
+  Node *best  = NULL;
+  Node *node  = start->next;
+
+  while (true) {
+    if (!is_sentinel(node) && is_eligible(ring, node) && is_better_priority(node, best)) {
+      best = node;
+    }
+    if (node == start) {
+      break;
+    }
+    node = node->next;
+  }
+
+  if (best != NULL) {
+    ring->current = best;
+  }
+}
+
+void locate_lowest_level(Ring *ring, bool keep) {
+  Node *start = ring->current;
+  Node *best  = (keep && !is_sentinel(start)) ? start : NULL;
+  Node *node  = start->next;
+
+  while (node != start) {
+    if (!is_sentinel(node) && is_eligible(ring, node) && is_better_level(node, best)) {
+      best = node;
     }
-    move_fwd(ring);
+    node = node->next;
+  }
+
+  if (best == NULL && !is_sentinel(start)) {
+    best = start;
   }
+  if (best != NULL) {
+    ring->current = best;
+  }
+}
+
+int locate_earliest_deadline(Ring *ring) {
+  Node *best = NULL;
+  Node *node = ring->first->next;
+
+  while (!is_sentinel(node)) {
+    pcb_t *pcb = (pcb_t*)node->item;
 
-  locate_by_id(ring, max_priority_pid);
+    if (pcb->rt.period != 0 && pcb->rt.left > 0 && !pcb->throttled && is_eligible(ring, node) &&
+        (best == NULL || pcb->rt.release + pcb->rt.deadline < ((pcb_t*)best->item)->rt.release + ((pcb_t*)best->item)->rt.deadline)) {
+      best = node;
+    }
+    node = node->next;
+  }
+
+  if (best == NULL) {
+    return 0;
+  }
+
+  ring->current = best;
+  return 1;
+}
+
+void boost_processes(Ring *ring) {
+  Node *node = ring->first->next;
+  while (!is_sentinel(node)) {
+    ((pcb_t*)node->item)->level = 0;
+    ((pcb_t*)node->item)->ticks = 0;
+    node = node->next;
+  }
 }
 
 void age_processes(Ring *ring) {
@@ -49,8 +49,9 @@ void insert_after(Ring *ring, void *item);
 // Return a new empty ring, containing only the sentinel node.
 Ring *create_ring();
 
-// Delete the current node, moving the current pointer forward to the next pcb.
+// Delete the current node, moving the current pointer back to the previous pcb.
 // Don't do anything if the current node is the sentinel node.
+// The item is not freed, since the caller may still hold (or reinsert) it.
 void delete(Ring *ring);
 
 // Print the given ring up to the maximum number of entries given.
@@ -62,6 +63,20 @@ int locate_by_id(Ring *ring, pid_t id);
 
 int locate_by_pipe_id(Ring *ring, pid_t id);
 
+// Sets the current pointer to a node containing a pcb in the thread group with
+// the given id. Return either 1 or 0 if the operation is successful or not respectively.
+int locate_by_tgid(Ring *ring, pid_t id);
+
+// Sets the current pointer to a node containing a pcb whose parent has the given
+// id. Return either 1 or 0 if the operation is successful or not respectively.
+int locate_by_ppid(Ring *ring, pid_t id);
+
+// Return the pcb with the given id without moving the current pointer, or NULL.
+pcb_t *get_process_by_id(Ring *ring, pid_t id);
+
+// Return the pipe with the given id without moving the current pointer, or NULL.
+pipe_t *get_pipe_by_id(Ring *ring, pid_t id);
+
 // Move the node at the current pointer to the end of the ring.
 void move_to_end(Ring *ring);
 
@@ -83,9 +98,23 @@ int get_current_pos_in_ring(Ring *ring);
 // Increments priority of all processes except current
 void age_processes(Ring *ring);
 
-// Moves current to highest priority pcb
+// Moves current to highest priority pcb, breaking ties round-robin
 void locate_highest_priority(Ring *ring);
 
+// Moves current to the pcb at the lowest (i.e., highest priority) level,
+// breaking ties round-robin; if keep, current stays put unless beaten
+void locate_lowest_level(Ring *ring, bool keep);
+
+// Resets the level and quantum used of all processes
+void boost_processes(Ring *ring);
+
+// Moves current to the unthrottled real-time pcb with budget left whose deadline is
+// earliest, returning 1 or 0 if there is such a pcb or not respectively
+int locate_earliest_deadline(Ring *ring);
+
+// Returns true iff. the node is the sentinel node.
+bool is_sentinel(Node *node);
+
 // Returns the largest pid in use
 int get_max_pid(Ring *ring);
 
@@ -0,0 +1,277 @@
+#include "sched.h"
+
+extern Ring *pcb_ring;
+
+int      sched_policy;
+uint32_t sched_ticks;
+uint32_t sched_last[CPUS];          // sched_ticks as of the last tick on each core
+
+group_t  sched_groups[SCHED_GROUPS];
+
+// quantum (in timer ticks) of each level
+int mlfq_quantum[MLFQ_LEVELS] = { 1, 2, 4, 8 };
+
+void sched_init(int policy) {
+  sched_policy = policy;
+  sched_ticks  = clock_read() / SCHED_PERIOD;
+
+  for (int i = 0; i < CPUS; i++) {
+    sched_last[i] = sched_ticks;
+  }
+
+  memset(sched_groups, 0, sizeof(sched_groups));
+}
+
+int sched_set_policy(int policy) {
+  if (policy != SCHED_PRIORITY && policy != SCHED_MLFQ) {
+    return -1;
+  }
+
+  // levels are left as they were when MLFQ was last used, so start afresh
+  if (policy == SCHED_MLFQ && sched_policy != SCHED_MLFQ) {
+    boost_processes(pcb_ring);
+  }
+
+  sched_policy = policy;
+
+  return 0;
+}
+
+// account n ticks to the current process, returning true iff. its quantum
+// expired (or every process was boosted, i.e., time crossed a multiple of
+// MLFQ_BOOST, which at most one core sees per multiple)
+bool sched_tick_mlfq(Ring *ring, uint32_t n, bool boost) {
+  pcb_t *current = get_current_process(ring);
+
+  if (boost) {
+    boost_processes(ring);
+    return true;
+  }
+  else if ((current->ticks += n) >= mlfq_quantum[current->level]) {
+    // used a full quantum, so drop a level
+    if (current->level < MLFQ_LEVELS - 1) {
+      current->level++;
+    }
+    current->ticks = 0;
+    return true;
+  }
+
+  return false;
+}
+
+// density of a real-time process, in units of 1 / RT_UTIL_ONE
+uint32_t rt_util(pcb_t *pcb) {
+  return pcb->rt.budget * RT_UTIL_ONE / pcb->rt.deadline;
+}
+
+int sched_rt(pcb_t *pcb, uint32_t period, uint32_t budget, uint32_t deadline) {
+  if (deadline == 0) {
+    deadline = period;
+  }
+  if (budget == 0 || budget > deadline || deadline > period) {
+    return -1;
+  }
+
+  uint32_t util = budget * RT_UTIL_ONE / deadline;
+
+  for (Node *node = pcb_ring->first->next; !is_sentinel(node); node = node->next) {
+    pcb_t *other = (pcb_t*)node->item;
+
+    if (other != pcb && other->rt.period != 0) {
+      util += rt_util(other);
+    }
+  }
+
+  if (util > RT_UTIL_MAX) {
+    return -1;
+  }
+
+  pcb->rt.period   = period;
+  pcb->rt.budget   = budget;
+  pcb->rt.deadline = deadline;
+  pcb->rt.release  = sched_ticks;
+  pcb->rt.left     = budget;
+  pcb->throttled   = false;
+
+  return 0;
+}
+
+int sched_group_create(uint32_t quota, uint32_t period) {
+  if (quota == 0 || quota > period) {
+    return -1;
+  }
+
+  // group 0 is the unlimited root group, so is never handed out
+  for (int i = 1; i < SCHED_GROUPS; i++) {
+    if (sched_groups[i].period == 0) {
+      sched_groups[i].quota  = quota;
+      sched_groups[i].period = period;
+      sched_groups[i].start  = sched_ticks;
+      sched_groups[i].used   = 0;
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+int sched_group_move(pcb_t *pcb, int group) {
+  if (group < 0 || group >= SCHED_GROUPS || (group != 0 && sched_groups[group].period == 0)) {
+    return -1;
+  }
+
+  pcb->group = group;
+  return 0;
+}
+
+// a group is exhausted once it has used its quota for the current period
+bool group_exhausted(int group) {
+  return sched_groups[group].period != 0 && sched_groups[group].used >= sched_groups[group].quota;
+}
+
+// charge the current process (and its group) for n ticks, refill groups,
+// release or expire real-time jobs, then decide which are throttled
+void sched_tick(Ring *ring, uint32_t n) {
+  pcb_t *current = get_current_process(ring);
+
+  if (current->rt.period != 0) {
+    current->rt.left = (current->rt.left > n) ? current->rt.left - n : 0;
+  }
+
+  sched_groups[current->group].used += n;
+
+  for (int i = 1; i < SCHED_GROUPS; i++) {
+    if (sched_groups[i].period == 0) {
+      continue;
+    }
+
+    while (sched_ticks - sched_groups[i].start >= sched_groups[i].period) {
+      sched_groups[i].start += sched_groups[i].period;
+      sched_groups[i].used   = 0;
+    }
+  }
+
+  for (Node *node = ring->first->next; !is_sentinel(node); node = node->next) {
+    pcb_t *pcb = (pcb_t*)node->item;
+
+    if (pcb->rt.period != 0) {
+      if (pcb->rt.left > 0 && sched_ticks - pcb->rt.release >= pcb->rt.deadline) {
+        pcb->rt.misses++;
+        stats.rt_misses++;
+        pcb->rt.left = 0;
+      }
+
+      while (sched_ticks - pcb->rt.release >= pcb->rt.period) {
+        pcb->rt.release += pcb->rt.period;
+        pcb->rt.left     = pcb->rt.budget;
+      }
+    }
+
+    sched_throttle(pcb);
+  }
+}
+
+void sched_throttle(pcb_t *pcb) {
+  // idle processes (with negative PIDs) are always throttled
+  pcb->throttled = (pcb->rt.period != 0 && pcb->rt.left == 0) || group_exhausted(pcb->group) || pcb->pid < 0 ||
+                   pcb->wait != 0;
+}
+
+// pass the priority (and level) of each blocked process down the chain of
+// processes it waits for, st. none is held up by one which is worse
+void sched_inherit(Ring *ring) {
+  for (Node *node = ring->first->next; !is_sentinel(node); node = node->next) {
+    pcb_t *pcb = (pcb_t*)node->item;
+
+    pcb->inherited_priority = INT_MIN;
+    pcb->inherited_level    = MLFQ_LEVELS;
+  }
+
+  for (Node *node = ring->first->next; !is_sentinel(node); node = node->next) {
+    pcb_t *pcb    = (pcb_t*)node->item;
+    pcb_t *holder = pcb;
+
+    // bound the walk, in case of a cycle (i.e., a deadlock)
+    for (int i = 0; i < MAX_PROGS && holder->wait != 0 && holder->holder != 0; i++) {
+      holder = get_process_by_id(ring, holder->holder);
+
+      if (holder == NULL) {
+        break;
+      }
+
+      if (pcb->priority > holder->inherited_priority) {
+        holder->inherited_priority = pcb->priority;
+      }
+      if (pcb->level < holder->inherited_level) {
+        holder->inherited_level = pcb->level;
+      }
+    }
+  }
+}
+
+// move the current pointer to the process to run next, keeping the
+// current process (if the policy allows) unless beaten
+void sched_locate(Ring *ring, bool keep) {
+  switch (sched_policy) {
+    case SCHED_MLFQ: {
+      locate_lowest_level(ring, keep);
+      break;
+    }
+    default: {
+      locate_highest_priority(ring);
+      break;
+    }
+  }
+
+  // real-time processes with budget left preempt either policy
+  locate_earliest_deadline(ring);
+}
+
+void sched_next(int why) {
+  pcb_t   *current = get_current_process(pcb_ring);
+  bool     keep    = (why != SCHED_YIELD && why != SCHED_BLOCK);
+  uint32_t n       = 0;
+  bool     boost   = false;
+
+  if (why == SCHED_TICK) {
+    // the cores tick off different timers, so each charges for the time
+    // elapsed since its last tick, as per the (shared) monotonic clock
+    uint32_t now = clock_read() / SCHED_PERIOD;
+
+    n     = now - sched_last[cpu_id()];
+    boost = now / MLFQ_BOOST != sched_ticks / MLFQ_BOOST;
+
+    sched_last[cpu_id()] = now;
+    sched_ticks          = now;
+
+    sched_tick(pcb_ring, n);
+  }
+  else if (why == SCHED_YIELD && current->rt.period != 0) {
+    // a real-time process which yields has finished its current job
+    current->rt.left   = 0;
+    current->throttled = true;
+  }
+
+  switch (sched_policy) {
+    case SCHED_MLFQ: {
+      // keep running the current process unless its quantum expired, or
+      // a process at a higher level is waiting
+      if (why == SCHED_TICK && sched_tick_mlfq(pcb_ring, n, boost)) {
+        keep = false;
+      }
+      break;
+    }
+    default: {
+      age_processes(pcb_ring);
+      break;
+    }
+  }
+
+  sched_inherit(pcb_ring);
+  sched_locate(pcb_ring, keep);
+
+  // an idle core tries to find work elsewhere before settling for idle
+  if (get_current_process(pcb_ring)->pid < 0 && smp_steal()) {
+    sched_locate(pcb_ring, false);
+  }
+}
@@ -0,0 +1,103 @@
+#ifndef __SCHED_H
+#define __SCHED_H
+
+#include "hilevel.h"
+
+/* The scheduling policy is selected at boot from SCHED_POLICY (which can
+ * be overridden at build time, e.g., -DSCHED_POLICY=SCHED_MLFQ), and can
+ * be switched at run time by the sched_policy system call (e.g., via the
+ * console's sched command), st. both can be compared on one image:
+ *
+ * - SCHED_PRIORITY is the original policy, i.e., a static priority per
+ *   process, aged by +1 per scheduler invocation while waiting, and
+ * - SCHED_MLFQ     is a multi-level feedback queue: processes start at
+ *   level 0, drop a level once they use a full quantum (quanta double
+ *   per level), keep their level if they yield early, and every level
+ *   is boosted back to 0 every MLFQ_BOOST ticks to avoid starvation.
+ *
+ * In both cases, ties are broken round-robin in ring order.
+ *
+ * Time is measured in timer ticks of SCHED_PERIOD clock ticks each, read
+ * off the monotonic clock: each core charges the process it is running
+ * for however many ticks elapsed since that core last ticked, st. cores
+ * ticking off timers with different periods still agree.
+ *
+ * Ahead of either policy sits a real-time class: a process declares a
+ * (period, budget, deadline) triple, in timer ticks, and is admitted iff.
+ * the total density sum( budget / deadline ) stays within RT_UTIL_MAX,
+ * which is a sufficient condition for EDF to meet every deadline.  Each
+ * release then gets budget ticks, enforced by the timer, and real-time
+ * processes with budget left are dispatched earliest-deadline-first.  A
+ * process is throttled (i.e., not dispatched while any other process is
+ * runnable) once its budget is used, or it yields, until its next release,
+ * and a release still holding budget at its deadline counts as a miss.
+ *
+ * Finally, each process belongs to a group (inherited across fork), and
+ * each group other than the root group 0 has a CPU quota of quota ticks
+ * per period ticks: once a group uses its quota every member process is
+ * throttled, until the quota is refilled at the start of the next period.
+ *
+ * A process blocked in futex_wait is throttled too, until woken.  If it
+ * is known which process it waits for (the holder of a lock, the other
+ * end of a pipe, or a thread being joined), the holder inherits its
+ * priority (or level) while it waits, transitively along any chain of
+ * such processes, st. a process with a better priority is never held up
+ * by a worse one which in turn cannot run for a third.
+ */
+
+#define SCHED_PRIORITY 0
+#define SCHED_MLFQ     1
+
+#define SCHED_TICK     0 // invoked by the timer
+#define SCHED_YIELD    1 // invoked by the current process giving up the processor
+#define SCHED_WAKE     2 // invoked because another process may now be able to run
+#define SCHED_BLOCK    3 // invoked by the current process waiting for another
+
+#ifndef SCHED_POLICY
+#define SCHED_POLICY SCHED_PRIORITY
+#endif
+
+#define SCHED_PERIOD   0x00001000 // length of a timer tick (i.e., TIMER0 period), in clock ticks
+
+#define MLFQ_LEVELS 4
+#define MLFQ_BOOST  64
+
+#define RT_UTIL_ONE 1024
+#define RT_UTIL_MAX ( RT_UTIL_ONE * 9 / 10 )
+
+#define SCHED_GROUPS 8
+
+typedef struct {
+  uint32_t quota;                   // ticks of execution per period
+  uint32_t period;                  // ticks between refills (0 => unused)
+  uint32_t start;                   // tick of current period
+  uint32_t used;                    // ticks used in current period
+} group_t;
+
+extern int sched_policy;
+
+// Select the scheduling policy.
+void sched_init(int policy);
+
+// Switch to the given scheduling policy; return 0, or -1 if no such policy.
+int  sched_set_policy(int policy);
+
+// Admit the process as real-time with the given parameters (deadline 0 =>
+// deadline = period); return 0 if admitted, or -1 if not schedulable.
+int sched_rt(pcb_t *pcb, uint32_t period, uint32_t budget, uint32_t deadline);
+
+// Create a group with the given quota per period; return its id, or -1.
+int sched_group_create(uint32_t quota, uint32_t period);
+
+// Move the process into the given group; return 0, or -1 if no such group.
+int sched_group_move(pcb_t *pcb, int group);
+
+// Decide whether the process is throttled, i.e., only dispatched if nothing
+// else is runnable.
+void sched_throttle(pcb_t *pcb);
+
+// Account for the current process, then move the current pointer of the
+// pcb ring to the process to run next: why is one of SCHED_TICK etc.
+void sched_next(int why);
+
+#endif
@@ -0,0 +1,111 @@
+#include "shm.h"
+
+// location of bottom of shared memory region
+extern uint32_t bos_shm;
+
+// one entry per page, counting up from bos_shm
+bool  shm_map[SHM_PAGES];
+shm_t shm_segments[SHM_SEGMENTS];
+
+// first fit, searching up from the bottom
+uint32_t shm_alloc(int pages) {
+  int run = 0;
+
+  for (int i = 0; i < SHM_PAGES; i++) {
+    run = shm_map[i] ? 0 : run + 1;
+
+    if (run == pages) {
+      int first = i - pages + 1;
+
+      for (int j = first; j <= i; j++) {
+        shm_map[j] = true;
+      }
+
+      return (uint32_t) &bos_shm + first * SHM_PAGE;
+    }
+  }
+
+  return 0;
+}
+
+void shm_free(shm_t *shm) {
+  uint32_t first = (shm->base - (uint32_t) &bos_shm) / SHM_PAGE;
+
+  for (uint32_t j = first; j < first + shm->size / SHM_PAGE; j++) {
+    shm_map[j] = false;
+  }
+
+  shm->base = 0;
+}
+
+int shm_create(uint32_t size) {
+  uint32_t pages = (size + SHM_PAGE - 1) / SHM_PAGE;
+
+  if (pages == 0 || pages > SHM_PAGES) {
+    return -1;
+  }
+
+  for (int i = 0; i < SHM_SEGMENTS; i++) {
+    if (shm_segments[i].base != 0) {
+      continue;
+    }
+
+    uint32_t base = shm_alloc(pages);
+
+    if (base == 0) {
+      return -1;
+    }
+
+    // zero the segment, st. nothing leaks from whoever used it before
+    memset((void *) base, 0, pages * SHM_PAGE);
+
+    shm_segments[i].base = base;
+    shm_segments[i].size = pages * SHM_PAGE;
+    shm_segments[i].refs = 0;
+
+    return i;
+  }
+
+  return -1;
+}
+
+uint32_t shm_attach(pcb_t *pcb, int id) {
+  if (id < 0 || id >= SHM_SEGMENTS || shm_segments[id].base == 0) {
+    return 0;
+  }
+
+  if (!(pcb->shm & (1 << id))) {
+    pcb->shm |= (1 << id);
+    shm_segments[id].refs++;
+  }
+
+  return shm_segments[id].base;
+}
+
+int shm_detach(pcb_t *pcb, int id) {
+  if (id < 0 || id >= SHM_SEGMENTS || !(pcb->shm & (1 << id))) {
+    return -1;
+  }
+
+  pcb->shm &= ~(1 << id);
+
+  if (--shm_segments[id].refs == 0) {
+    shm_free(&shm_segments[id]);
+  }
+
+  return 0;
+}
+
+void shm_fork(pcb_t *child, pcb_t *parent) {
+  for (int i = 0; i < SHM_SEGMENTS; i++) {
+    if (parent->shm & (1 << i)) {
+      shm_attach(child, i);
+    }
+  }
+}
+
+void shm_exit(pcb_t *pcb) {
+  for (int i = 0; i < SHM_SEGMENTS; i++) {
+    shm_detach(pcb, i);
+  }
+}
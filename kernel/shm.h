@@ -0,0 +1,43 @@
+#ifndef __SHM_H
+#define __SHM_H
+
+#include "hilevel.h"
+
+/* Shared memory segments are carved out of the region between the linker
+ * symbols bos_shm and tos_shm in units of SHM_PAGE bytes, so each segment
+ * is page-aligned.  There is (as yet) a single address space, so rather
+ * than be mapped into each process a segment has the same address in
+ * all of them: attaching only records that the process uses it.
+ *
+ * Each process has a bitmap of the segments it is attached to, which is
+ * inherited across fork; a segment is freed once the last process which
+ * attached to it detaches (explicitly, or by exiting).  The system call
+ * attaches the creator of a segment, st. it always has someone to free it.
+ */
+
+#define SHM_PAGE     0x00001000
+#define SHM_PAGES    ( 0x00100000 / SHM_PAGE )
+#define SHM_SEGMENTS 16
+
+typedef struct {
+  uint32_t base;                    // address of first byte (0 => unused)
+  uint32_t size;                    // bytes, rounded up to whole pages
+  int      refs;                    // processes attached
+} shm_t;
+
+// Create a zeroed segment of (at least) size bytes; return its id, or -1.
+int      shm_create(uint32_t size);
+
+// Attach the process to the segment; return its address, or 0 if no such segment.
+uint32_t shm_attach(pcb_t *pcb, int id);
+
+// Detach the process from the segment; return 0, or -1 if not attached.
+int      shm_detach(pcb_t *pcb, int id);
+
+// Attach the child to every segment the parent is attached to.
+void     shm_fork(pcb_t *child, pcb_t *parent);
+
+// Detach the process from every segment.
+void     shm_exit(pcb_t *pcb);
+
+#endif
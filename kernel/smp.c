@@ -0,0 +1,131 @@
+#include "smp.h"
+
+extern Ring *pcb_ring;
+
+// entry point for secondary cores
+extern void lolevel_handler_smp();
+
+// read MPIDR, which is only meaningful on a multi-core system
+extern int  smp_cpu_id();
+
+// wake any core waiting for an event
+extern void smp_sev();
+
+uint32_t     kernel_lock_word;
+struct node *cpu_current[ CPUS ];
+
+int cpu_id() {
+#if CPUS > 1
+  return smp_cpu_id();
+#else
+  return 0;
+#endif
+}
+
+void kernel_lock() {
+#if CPUS > 1
+  spin_lock(&kernel_lock_word);
+
+  if (cpu_current[cpu_id()] != NULL) {
+    pcb_ring->current = cpu_current[cpu_id()];
+  }
+#endif
+}
+
+void kernel_unlock() {
+#if CPUS > 1
+  cpu_current[cpu_id()] = pcb_ring->current;
+
+  spin_unlock(&kernel_lock_word);
+#endif
+}
+
+void smp_init_cpu() {
+  GICC0->PMR          = 0x000000F0; // unmask all            interrupts
+  GICD0->ISENABLER0   = ( 1 << SGI_RESCHED       ) // enable reschedule SGI
+                      | ( 1 << GIC_SOURCE_PTIMER ); // enable private timer interrupt
+  GICC0->CTLR         = 0x00000001; // enable GIC interface
+
+  // core 0 ticks off TIMER0, so only secondary cores use the private timer
+  if (cpu_id() != 0) {
+    PTIMER0->Load  = SMP_TICK;      // select period
+    PTIMER0->Ctrl  = 0x00000007;    // enable timer, auto-reload and interrupt
+  }
+}
+
+void smp_boot() {
+  SCU0->CTRL         |= 0x00000001; // enable SCU
+
+  // lolevel_handler_rst parks each secondary core until woken, then has
+  // it jump to the address in the system flags register
+  SYSCONF->FLAGSCLR   = 0xFFFFFFFF;
+  SYSCONF->FLAGSSET   = ( uint32_t )( &lolevel_handler_smp );
+
+  smp_sev();                        // wake all other cores
+}
+
+// count the non-idle processes homed on each core, optionally only
+// those waiting (i.e., neither running nor throttled)
+void smp_load(int *load, bool waiting) {
+  for (int i = 0; i < CPUS; i++) {
+    load[i] = 0;
+  }
+
+  for (Node *node = pcb_ring->first->next; !is_sentinel(node); node = node->next) {
+    pcb_t *pcb = (pcb_t*)node->item;
+
+    if (pcb->pid > 0 && (!waiting || (!pcb->running && !pcb->throttled))) {
+      load[pcb->cpu]++;
+    }
+  }
+}
+
+int smp_place() {
+  int load[ CPUS ], best = cpu_id();
+
+  smp_load(load, false);
+
+  for (int i = 0; i < CPUS; i++) {
+    if (load[i] < load[best]) {
+      best = i;
+    }
+  }
+
+  return best;
+}
+
+void smp_kick(int cpu) {
+#if CPUS > 1
+  GICD0->SGIR = ( 1 << ( 16 + cpu ) ) | SGI_RESCHED;
+#else
+  // with one core, there is no other to kick
+  (void) cpu;
+#endif
+}
+
+bool smp_steal() {
+  int load[ CPUS ], victim = cpu_id();
+
+  smp_load(load, true);
+
+  for (int i = 0; i < CPUS; i++) {
+    if (load[i] > load[victim]) {
+      victim = i;
+    }
+  }
+
+  if (victim == cpu_id()) {
+    return false;
+  }
+
+  for (Node *node = pcb_ring->first->next; !is_sentinel(node); node = node->next) {
+    pcb_t *pcb = (pcb_t*)node->item;
+
+    if (pcb->pid > 0 && pcb->cpu == victim && !pcb->running && !pcb->throttled) {
+      pcb->cpu = cpu_id();
+      return true;
+    }
+  }
+
+  return false;
+}
@@ -0,0 +1,66 @@
+#ifndef __SMP_H
+#define __SMP_H
+
+#include "hilevel.h"
+
+#include "MPCore.h"
+#include    "SYS.h"
+
+/* When built with CPUS > 1, each core runs the same kernel: a big kernel
+ * lock serialises every handler, st. all kernel state is shared as-is,
+ * and the current pointer of the pcb ring is swapped in for whichever
+ * core holds the lock.  Each process has a home core, i.e., the ring is
+ * partitioned into per-core run queues:
+ *
+ * - a core only dispatches processes homed on it and not already running,
+ * - each core has an idle process (with PID -1 - core), which is only
+ *   dispatched if nothing else can be, at which point the core tries to
+ *   steal a waiting process from the busiest core,
+ * - new processes are homed on the least loaded core, which is woken by
+ *   an SGI (i.e., an inter-processor interrupt) if need be, and
+ * - QEMU starts every core at the reset handler, which parks all bar
+ *   core 0 (in wfe) until smp_boot gives them an entry point,
+ * - each secondary core ticks off its private timer, whereas core 0 keeps
+ *   using TIMER0, and each charges in elapsed time (see sched.h).
+ *
+ * With CPUS = 1 the lock and current pointer swap compile away.
+ */
+
+#define SGI_RESCHED 0
+#define SMP_TICK    0x00100000
+
+extern struct node *cpu_current[ CPUS ];
+
+// Return the number of the executing core.
+int  cpu_id();
+
+// Tell user mode on this core which process is running.
+void smp_set_tls(uint32_t x);
+
+// Acquire and release a spinlock.
+void spin_lock(uint32_t *x);
+void spin_unlock(uint32_t *x);
+
+// Acquire the big kernel lock, and make this core's process current.
+void kernel_lock();
+
+// Record this core's current process, and release the big kernel lock.
+void kernel_unlock();
+
+// Configure the GIC interface and timer of the executing core.
+void smp_init_cpu();
+
+// Start the secondary cores.
+void smp_boot();
+
+// Return the core a new process should be homed on.
+int  smp_place();
+
+// Ask the given core to reschedule.
+void smp_kick(int cpu);
+
+// Rehome a waiting process from the busiest core onto this one; return
+// true iff. there was such a process.
+bool smp_steal();
+
+#endif
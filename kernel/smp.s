@@ -0,0 +1,51 @@
+/* The following functions support multiple cores: smp_cpu_id reads
+ * the core number from MPIDR (which is only meaningful on a multi-core
+ * system, so cpu_id wraps it), smp_set_tls writes TPIDRURO (i.e., the
+ * per-core register user mode may read but not write, which the kernel
+ * sets to the PID of the process it dispatches), smp_sev wakes cores
+ * parked in wfe (i.e., by lolevel_handler_rst), whereas spin_lock and
+ * spin_unlock use exclusive loads and stores to implement a simple spinlock, with
+ * barriers st. memory accesses in the critical section cannot move
+ * outside it, and wfe/sev st. cores waiting for the lock sleep rather
+ * than spin.
+ */
+
+.global smp_cpu_id
+.global smp_set_tls
+.global smp_sev
+
+.global spin_lock
+.global spin_unlock
+
+smp_cpu_id:          mrc   p15, 0, r0, c0, c0, 5   @ read  MPIDR
+                     and   r0, r0, #0x3            @ extract CPU ID
+
+                     mov   pc, lr                  @ return
+
+smp_set_tls:         mcr   p15, 0, r0, c13, c0, 3  @ write TPIDRURO
+
+                     mov   pc, lr                  @ return
+
+smp_sev:             dsb                           @ barrier: prior stores before waking cores
+                     sev                           @ wake  cores waiting for an event
+
+                     mov   pc, lr                  @ return
+
+spin_lock:           mov   r1, #1
+l1:                  ldrex r2, [ r0 ]              @ load  lock, marking it for exclusive access
+                     cmp   r2, #0
+                     wfene                         @ wait  while lock is held
+                     strexeq r2, r1, [ r0 ]        @ store 1 iff. lock was free
+                     cmpeq r2, #0                  @       ... and the store succeeded
+                     bne   l1                      @ loop  otherwise
+                     dmb                           @ barrier: lock before critical section
+
+                     mov   pc, lr                  @ return
+
+spin_unlock:         mov   r1, #0
+                     dmb                           @ barrier: critical section before unlock
+                     str   r1, [ r0 ]              @ store 0, i.e., release lock
+                     dsb                           @ barrier: unlock before waking cores
+                     sev                           @ wake  cores waiting for lock
+
+                     mov   pc, lr                  @ return
@@ -0,0 +1,73 @@
+#include "stack.h"
+
+// location of top of stack for user programs
+extern uint32_t tos_user_progs;
+
+// one entry per allocation unit, counting down from tos_user_progs
+bool stack_map[STACK_UNITS];
+
+uint32_t stack_round(uint32_t size) {
+  return (size + STACK_UNIT - 1) & ~(STACK_UNIT - 1);
+}
+
+// first fit, searching down from the top st. stacks are packed as before
+uint32_t stack_alloc(uint32_t size) {
+  int units = stack_round(size) / STACK_UNIT;
+  int run   = 0;
+
+  if (units == 0) {
+    return 0;
+  }
+
+  for (int i = 0; i < STACK_UNITS; i++) {
+    run = stack_map[i] ? 0 : run + 1;
+
+    if (run == units) {
+      int first = i - units + 1;
+
+      for (int j = first; j <= i; j++) {
+        stack_map[j] = true;
+      }
+
+      return (uint32_t) &tos_user_progs - first * STACK_UNIT;
+    }
+  }
+
+  return 0;
+}
+
+void stack_free(uint32_t tos, uint32_t size) {
+  int first = ((uint32_t) &tos_user_progs - tos) / STACK_UNIT;
+  int units = stack_round(size) / STACK_UNIT;
+
+  for (int j = first; j < first + units && j < STACK_UNITS; j++) {
+    stack_map[j] = false;
+  }
+}
+
+void stack_poison(uint32_t tos, uint32_t size) {
+  uint32_t *bos = (uint32_t *) (tos - size);
+
+  for (uint32_t i = 0; i < size / sizeof(uint32_t); i++) {
+    bos[i] = STACK_POISON;
+  }
+
+  bos[0] = STACK_GUARD;
+}
+
+bool stack_check(uint32_t tos, uint32_t size) {
+  return *((uint32_t *) (tos - size)) == STACK_GUARD;
+}
+
+uint32_t stack_used(uint32_t tos, uint32_t size) {
+  uint32_t *bos = (uint32_t *) (tos - size);
+
+  // skip the guard word, then find the lowest word no longer poisoned
+  for (uint32_t i = 1; i < size / sizeof(uint32_t); i++) {
+    if (bos[i] != STACK_POISON) {
+      return size - i * sizeof(uint32_t);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,41 @@
+#ifndef __STACK_H
+#define __STACK_H
+
+#include "hilevel.h"
+
+/* User program stacks are carved out of the region below the linker
+ * symbol tos_user_progs in units of STACK_UNIT bytes, st. any program
+ * with a small stack need not occupy a full STACK_SIZE slot:
+ *
+ * - each stack is filled with STACK_POISON when a program is exec'd, so
+ *   the high-water mark can be found later as the lowest word which no
+ *   longer holds the poison value, and
+ * - the lowest word of each stack holds STACK_GUARD, which is checked at
+ *   each context switch to catch an overflow into the stack below.
+ */
+
+#define STACK_UNIT   0x00000400
+#define STACK_UNITS  ( 0x00410000 / STACK_UNIT )
+
+#define STACK_POISON 0xA5A5A5A5
+#define STACK_GUARD  0x600DF00D
+
+// Allocate a stack of (at least) size bytes; return the top of stack, or 0.
+uint32_t stack_alloc(uint32_t size);
+
+// Free the stack of size bytes with the given top of stack.
+void stack_free(uint32_t tos, uint32_t size);
+
+// Fill the stack with poison and place the guard word at its base.
+void stack_poison(uint32_t tos, uint32_t size);
+
+// Return true iff. the guard word at the base of the stack is intact.
+bool stack_check(uint32_t tos, uint32_t size);
+
+// Return the number of bytes of the stack which have ever been used.
+uint32_t stack_used(uint32_t tos, uint32_t size);
+
+// Round size up to a whole number of allocation units.
+uint32_t stack_round(uint32_t size);
+
+#endif
@@ -0,0 +1,47 @@
+#include "stats.h"
+
+#include "SYS.h"
+
+stats_t  stats;
+uint32_t stats_epoch;
+
+void stats_init() {
+  memset(&stats, 0, sizeof(stats_t));
+
+  stats_epoch = SYSCONF->COUNTER_100HZ;
+}
+
+// the low word of the monotonic clock, which is cheaper to read in full
+uint32_t stats_now() {
+  return ~TIMER0->Timer2Value;
+}
+
+void stats_copy(stats_t *x) {
+  stats.uptime = SYSCONF->COUNTER_100HZ - stats_epoch;
+  stats.clock  = stats_now();
+
+  memcpy(x, &stats, sizeof(stats_t));
+}
+
+void stats_irq(uint32_t id) {
+  if (id < STATS_IRQS) {
+    stats.irq[id]++;
+  }
+}
+
+void stats_svc(uint32_t id) {
+  if (id < STATS_SVCS) {
+    stats.svc[id]++;
+  }
+}
+
+void stats_dispatch(uint32_t latency) {
+  int bucket = (latency == 0) ? 0 : 32 - __builtin_clz(latency);
+
+  if (bucket >= STATS_BUCKETS) {
+    bucket = STATS_BUCKETS - 1;
+  }
+
+  stats.latency[bucket]++;
+  stats.switches++;
+}
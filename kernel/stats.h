@@ -0,0 +1,57 @@
+#ifndef __STATS_H
+#define __STATS_H
+
+#include "hilevel.h"
+
+/* The kernel maintains a set of always-on statistics counters, each of
+ * which costs at most an increment to keep: they capture
+ *
+ * - interrupts per GIC source and system calls per svc immediate,
+ * - context switches, plus the uptime they occurred over,
+ * - successful and failed (i.e., empty) pipe operations,
+ * - real-time deadline misses, and
+ * - a log2 histogram of scheduling latency, i.e., the number of clock
+ *   ticks between a process becoming runnable and being dispatched:
+ *   bucket i counts latencies in the range [ 2^(i-1), 2^i ).
+ *
+ * The layout must match stats_t as declared in libc.h.
+ */
+
+#define STATS_IRQS    96
+#define STATS_SVCS    64
+#define STATS_BUCKETS 32
+
+typedef struct {
+  uint32_t uptime;                   // 100Hz ticks since reset
+  uint32_t clock;                    // clock ticks since reset
+  uint32_t irq[ STATS_IRQS ];        // interrupts    per GIC source
+  uint32_t svc[ STATS_SVCS ];        // system calls  per svc immediate
+  uint32_t switches;                 // context switches
+  uint32_t pipe_writes;              // pipe writes
+  uint32_t pipe_reads;               // pipe reads which returned data
+  uint32_t pipe_empty;               // pipe reads which found no data
+  uint32_t rt_misses;                // real-time deadline misses
+  uint32_t latency[ STATS_BUCKETS ]; // scheduling latency histogram
+} stats_t;
+
+extern stats_t stats;
+
+// Reset the statistics; the clock used to timestamp events must be running.
+void stats_init();
+
+// Return the low word of the monotonic clock (see clock.h).
+uint32_t stats_now();
+
+// Copy the statistics, with uptime and clock brought up to date, into x.
+void stats_copy(stats_t *x);
+
+// Count an interrupt from the given GIC source.
+void stats_irq(uint32_t id);
+
+// Count a system call with the given svc immediate.
+void stats_svc(uint32_t id);
+
+// Count a dispatch after the given number of clock ticks spent runnable.
+void stats_dispatch(uint32_t latency);
+
+#endif
@@ -0,0 +1,127 @@
+#include "uring.h"
+
+extern Ring *pcb_ring;
+extern Ring *pipe_ring;
+
+extern int wake(uint32_t x, int n);
+
+void uring_setup(pcb_t *pcb, uring_t *ring) {
+  if (ring != NULL) {
+    ring->sq_head = ring->sq_tail = 0;
+    ring->cq_head = ring->cq_tail = 0;
+  }
+
+  pcb->uring = ring;
+}
+
+// as per the pipe system calls, only either end may use a pipe
+pipe_t *uring_pipe(pcb_t *pcb, int fd) {
+  pipe_t *pipe = get_pipe_by_id(pipe_ring, fd);
+
+  if (pipe == NULL || (pipe->proc1 != pcb->pid && pipe->proc2 != pcb->pid)) {
+    return NULL;
+  }
+
+  return pipe;
+}
+
+// only these never wait on a device, so may run from the timer tick
+bool uring_nonblocking(uring_sqe_t *sqe) {
+  return sqe->op == URING_NOP || sqe->op == URING_PIPE_WRITE || sqe->op == URING_PIPE_READ;
+}
+
+int uring_op(pcb_t *pcb, uring_sqe_t *sqe) {
+  switch (sqe->op) {
+    case URING_NOP: {
+      return 0;
+    }
+    case URING_WRITE: {
+      for (uint32_t i = 0; i < sqe->len; i++) {
+        PL011_putc(UART0, ((char *) sqe->addr)[i], true);
+      }
+      return sqe->len;
+    }
+    case URING_PIPE_WRITE: {
+      pipe_t *pipe = uring_pipe(pcb, sqe->fd);
+
+      if (pipe == NULL) {
+        return -1;
+      }
+
+      pipe->value = sqe->addr;
+      stats.pipe_writes++;
+      poll_wake(false);
+      return 0;
+    }
+    case URING_PIPE_READ: {
+      pipe_t *pipe = uring_pipe(pcb, sqe->fd);
+
+      if (pipe == NULL) {
+        return -1;
+      }
+
+      int value = pipe->value;
+
+      if (value == -1) {
+        stats.pipe_empty++;
+      } else {
+        stats.pipe_reads++;
+      }
+
+      pipe->value = -1;
+      poll_wake(false);
+      return value;
+    }
+    case URING_DISK_READ: {
+      return disk_rd(sqe->off, (uint8_t *) sqe->addr, sqe->len);
+    }
+    case URING_DISK_WRITE: {
+      return disk_wr(sqe->off, (const uint8_t *) sqe->addr, sqe->len);
+    }
+    default: {
+      return -1;
+    }
+  }
+}
+
+int uring_run(pcb_t *pcb, bool tick) {
+  uring_t *ring = pcb->uring;
+  int      n    = 0;
+
+  while (ring->sq_head != ring->sq_tail && ring->cq_tail - ring->cq_head < URING_ENTRIES) {
+    uring_sqe_t *sqe = &ring->sq[ring->sq_head % URING_ENTRIES];
+    uring_cqe_t *cqe = &ring->cq[ring->cq_tail % URING_ENTRIES];
+
+    // entries are consumed in order, so the rest wait for uring_enter
+    if (tick && !uring_nonblocking(sqe)) {
+      break;
+    }
+
+    cqe->user = sqe->user;
+    cqe->res  = uring_op(pcb, sqe);
+
+    // the completion must be visible before the tail which publishes it
+    __sync_synchronize();
+
+    ring->sq_head++;
+    ring->cq_tail++;
+    n++;
+  }
+
+  // wake the process if it waits for completions
+  if (n > 0) {
+    wake((uint32_t) &ring->cq_tail, 1);
+  }
+
+  return n;
+}
+
+void uring_tick() {
+  for (Node *node = pcb_ring->first->next; !is_sentinel(node); node = node->next) {
+    pcb_t *pcb = (pcb_t*)node->item;
+
+    if (pcb->uring != NULL && (pcb->uring->flags & URING_SQPOLL)) {
+      uring_run(pcb, true);
+    }
+  }
+}
@@ -0,0 +1,70 @@
+#ifndef __URING_H
+#define __URING_H
+
+#include "hilevel.h"
+#include   "disk.h"
+
+/* A process may register a pair of rings in its own memory (which the
+ * kernel can access directly) to batch system calls: it queues entries
+ * on the submission ring, then has the kernel consume every one queued
+ * by a single uring_enter system call, or (if URING_SQPOLL is set) by
+ * none at all, since the kernel then consumes them at each timer tick
+ * (up to the first which waits on a device, e.g., a disk operation; it
+ * is left for uring_enter, since interrupts are masked within the tick,
+ * which uring_submit in libc makes whenever such an entry is queued).
+ * A completion, carrying the user tag of its submission plus a result,
+ * is posted on the completion ring for each entry consumed.
+ *
+ * Each head and tail counts up without wrapping at the ring size; the
+ * process produces at sq_tail and cq_head, the kernel at sq_head and
+ * cq_tail.  Operations never block: e.g., reading an empty pipe gives
+ * -1, as per pipe_read.  The kernel stops consuming entries while the
+ * completion ring is full.  The layout must match libc.h.
+ */
+
+#define URING_ENTRIES    32          // power of 2
+
+#define URING_SQPOLL     0x01
+
+#define URING_NOP        0           // result = 0
+#define URING_WRITE      1           // write len bytes at addr to the console; result = len
+#define URING_PIPE_WRITE 2           // write addr into pipe fd; result = 0, or -1
+#define URING_PIPE_READ  3           // read pipe fd; result = value, or -1
+#define URING_DISK_READ  4           // read  len bytes at addr from disk block off; result = disk_rd
+#define URING_DISK_WRITE 5           // write len bytes at addr to   disk block off; result = disk_wr
+
+typedef struct {
+  uint32_t op;
+  int      fd;
+  uint32_t addr;
+  uint32_t len;
+  uint32_t off;
+  uint32_t user;                    // tag copied into the completion
+} uring_sqe_t;
+
+typedef struct {
+  uint32_t user;
+  int      res;
+} uring_cqe_t;
+
+typedef struct uring {
+  volatile uint32_t sq_head;
+  volatile uint32_t sq_tail;
+  volatile uint32_t cq_head;
+  volatile uint32_t cq_tail;
+  uint32_t          flags;
+  uring_sqe_t       sq[ URING_ENTRIES ];
+  uring_cqe_t       cq[ URING_ENTRIES ];
+} uring_t;
+
+// Register the rings of the process (NULL => unregister).
+void uring_setup(pcb_t *pcb, uring_t *ring);
+
+// Consume queued submissions of the process, stopping at the first which
+// waits on a device (e.g., the disk) iff. tick; return how many were consumed.
+int  uring_run(pcb_t *pcb, bool tick);
+
+// Consume queued non-blocking submissions of each process with URING_SQPOLL set.
+void uring_tick();
+
+#endif
@@ -0,0 +1,62 @@
+#include "vm.h"
+
+// placed on its own page by image.ld
+extern uint32_t clock_page;
+
+uint32_t vm_table[ VM_SECTIONS ] __attribute__ ((aligned (0x4000)));
+uint32_t vm_pages[ VM_PAGES    ] __attribute__ ((aligned (0x0400)));
+
+// with more than one core, normal memory is shared, so must be coherent
+#if CPUS > 1
+#define VM_SHARED_SECTION VM_SECTION_S
+#define VM_SHARED_PAGE    VM_PAGE_S
+#else
+#define VM_SHARED_SECTION 0
+#define VM_SHARED_PAGE    0
+#endif
+
+void vm_map(uint32_t first, uint32_t last, uint32_t attr) {
+  for (uint32_t i = first; i <= last; i++) {
+    vm_table[i] = (i << 20) | attr;
+  }
+}
+
+void vm_init() {
+  uint32_t ram = VM_SECTION | VM_SECTION_RW | VM_SECTION_WA | VM_SECTION_C | VM_SECTION_B | VM_SHARED_SECTION;
+  uint32_t dev = VM_SECTION | VM_SECTION_RW | VM_SECTION_XN;
+
+  vm_map(0x000, 0xFFF, 0x00000000);   // unmapped, i.e., faults
+  vm_map(0x000, 0x0FF, ram);          // RAM   (low alias, holding the vector table)
+  vm_map(0x100, 0x1FF, dev);          // peripherals
+  vm_map(0x700, 0x8FF, ram);          // RAM
+
+  // map the section holding the clock page by page, st. it is read-only
+  uint32_t page    = (uint32_t) &clock_page;
+  uint32_t section = page >> 20;
+
+  for (uint32_t i = 0; i < VM_PAGES; i++) {
+    uint32_t addr = (section << 20) | (i << 12);
+    uint32_t ap   = (addr == page) ? VM_PAGE_RO : VM_PAGE_RW;
+
+    vm_pages[i] = addr | VM_PAGE | ap | VM_PAGE_WA | VM_PAGE_C | VM_PAGE_B | VM_SHARED_PAGE;
+  }
+
+  vm_table[section] = (uint32_t) vm_pages | VM_TABLE;
+}
+
+void vm_cpu_init() {
+  // caches (and TLB) may hold junk from before reset
+  mmu_inv_dcache();
+  mmu_inv_icache();
+  mmu_flush();
+
+  mmu_set_ptr0(vm_table);
+  mmu_set_dom(0, 0x1);                // client => check access permissions
+
+#if CPUS > 1
+  mmu_set_smp();
+#endif
+
+  mmu_enable();
+  mmu_enable_cache();
+}
@@ -0,0 +1,52 @@
+#ifndef __VM_H
+#define __VM_H
+
+#include "hilevel.h"
+
+#include "MMU.h"
+
+/* Every process shares one address space, so the MMU only serves to set
+ * memory attributes: a single (short-descriptor) translation table maps
+ * each 1MiB section to itself, st.
+ *
+ * - RAM (i.e., the low alias holding the vector table, plus the kernel
+ *   image with its heap, stacks and shared memory) is normal memory,
+ *   cacheable write-back write-allocate,
+ * - the peripherals (i.e., UARTs, timers, GIC and SCU) are strongly
+ *   ordered and never executable, and
+ * - anything else is unmapped, so faults.
+ *
+ * The one exception is the section holding the clock page (see clock.h),
+ * which is mapped by a second-level table of 4KiB pages st. user mode may
+ * only read the clock page.  Everything is in domain 0, as a client, so
+ * the access permissions are checked.
+ */
+
+#define VM_SECTIONS    4096
+#define VM_PAGES        256
+
+#define VM_SECTION     0x00000002   // section    descriptor
+#define VM_TABLE       0x00000001   // page table descriptor
+#define VM_PAGE        0x00000002   // small page descriptor
+
+#define VM_SECTION_B   0x00000004   // section: bufferable
+#define VM_SECTION_C   0x00000008   // section: cacheable
+#define VM_SECTION_XN  0x00000010   // section: execute never
+#define VM_SECTION_RW  0x00000C00   // section: AP = 0b011 => read/write for all
+#define VM_SECTION_WA  0x00001000   // section: TEX = 0b001 => write-allocate
+#define VM_SECTION_S   0x00010000   // section: shareable
+
+#define VM_PAGE_B      0x00000004   // page:    bufferable
+#define VM_PAGE_C      0x00000008   // page:    cacheable
+#define VM_PAGE_RW     0x00000030   // page:    AP = 0b011 => read/write for all
+#define VM_PAGE_RO     0x00000020   // page:    AP = 0b010 => read/write for kernel, read-only for user
+#define VM_PAGE_WA     0x00000040   // page:    TEX = 0b001 => write-allocate
+#define VM_PAGE_S      0x00000400   // page:    shareable
+
+// Build the translation tables; must precede vm_cpu_init on any core.
+void vm_init();
+
+// Enable the MMU, caches and branch predictor on the calling core.
+void vm_cpu_init();
+
+#endif
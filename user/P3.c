@@ -16,7 +16,7 @@ int is_prime( uint32_t x ) {
 
 void main_P3() {
   for( int i = 0; i < 50; i++ ) {
-    write( STDOUT_FILENO, "P3", 2 );
+    fputs( "P3", stdout );
 
     uint32_t lo = 1 <<  8;
     uint32_t hi = 1 << 16;
@@ -26,7 +26,7 @@ void main_P3() {
     }
   }
 
-  write( STDOUT_FILENO, "endP3", 5 );
+  fputs( "endP3", stdout );
 
   exit( EXIT_SUCCESS );
 }
@@ -0,0 +1,117 @@
+#include "bench_mem.h"
+
+/* The memory benchmark times memcpy, memset and memcmp (i.e., the
+ * word-burst versions in mem.s) against byte-at-a-time loops, as per
+ * the newlib versions they replace, for each size class: it prints the
+ * cycles per call of each, less the cost of reading the cycle counter.
+ * The byte loops access memory via volatile pointers, st. the compiler
+ * cannot turn them back into calls to the functions being compared.
+ */
+
+#define BENCH_REPS 64
+#define BENCH_MAX  4096
+
+uint8_t bench_x[ BENCH_MAX ] __attribute__ ( ( aligned( 8 ) ) );
+uint8_t bench_y[ BENCH_MAX ] __attribute__ ( ( aligned( 8 ) ) );
+
+size_t bench_sizes[] = { 4, 16, 64, 256, 1024, 4096 };
+
+// results of memcmp, kept st. the calls cannot be optimised away
+volatile int bench_sink;
+
+void byte_memcpy( void* x, const void* y, size_t n ) {
+  volatile uint8_t*       d = x;
+  volatile const uint8_t* s = y;
+
+  while( n-- ) {
+    *d++ = *s++;
+  }
+}
+
+void byte_memset( void* x, int c, size_t n ) {
+  volatile uint8_t* d = x;
+
+  while( n-- ) {
+    *d++ = c;
+  }
+}
+
+int  byte_memcmp( const void* x, const void* y, size_t n ) {
+  volatile const uint8_t* a = x;
+  volatile const uint8_t* b = y;
+
+  for( ; n > 0; n--, a++, b++ ) {
+    if( *a != *b ) {
+      return *a - *b;
+    }
+  }
+
+  return 0;
+}
+
+// cycles taken by a back-to-back pair of reads of the cycle counter
+uint32_t bench_overhead() {
+  uint32_t t = pmu_read( 0, PMU_EVENT_CYCLES );
+
+  return pmu_read( 0, PMU_EVENT_CYCLES ) - t;
+}
+
+// run one operation (0 => memcpy, 1 => memset, 2 => memcmp) on n bytes
+// BENCH_REPS times, via mem.s iff. fast; return the cycles per call
+uint32_t bench_run( int op, size_t n, bool fast, uint32_t overhead ) {
+  uint32_t t = pmu_read( 0, PMU_EVENT_CYCLES );
+
+  for( int i = 0; i < BENCH_REPS; i++ ) {
+    if     ( op == 0 && fast ) {
+      memcpy( bench_x, bench_y, n );
+    }
+    else if( op == 0         ) {
+      byte_memcpy( bench_x, bench_y, n );
+    }
+    else if( op == 1 && fast ) {
+      memset( bench_x, i, n );
+    }
+    else if( op == 1         ) {
+      byte_memset( bench_x, i, n );
+    }
+    else if(            fast ) {
+      bench_sink = memcmp( bench_x, bench_y, n );
+    }
+    else {
+      bench_sink = byte_memcmp( bench_x, bench_y, n );
+    }
+  }
+
+  t = pmu_read( 0, PMU_EVENT_CYCLES ) - t - overhead;
+
+  return t / BENCH_REPS;
+}
+
+void main_bench_mem() {
+  char* names[] = { "memcpy", "memset", "memcmp" };
+
+  pmu_open( 0, PMU_EVENT_CYCLES );
+
+  uint32_t overhead = bench_overhead();
+
+  printf( "op     size  byte  burst (cycles per call)\n" );
+
+  for( int op = 0; op < 3; op++ ) {
+    for( size_t i = 0; i < sizeof( bench_sizes ) / sizeof( size_t ); i++ ) {
+      size_t n = bench_sizes[ i ];
+
+      // equal buffers, st. memcmp compares all n bytes
+      memset( bench_x, 0, n );
+      memset( bench_y, 0, n );
+
+      uint32_t slow = bench_run( op, n, false, overhead );
+      uint32_t fast = bench_run( op, n, true,  overhead );
+
+      printf( "%s %5u %5u %5u\n", names[ op ], n, slow, fast );
+    }
+  }
+
+  pmu_close( 0, PMU_EVENT_CYCLES );
+
+  exit( EXIT_SUCCESS );
+}
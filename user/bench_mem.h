@@ -0,0 +1,12 @@
+#ifndef __BENCH_MEM_H
+#define __BENCH_MEM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string.h>
+
+#include "libc.h"
+
+#endif
@@ -0,0 +1,50 @@
+#include "bench_svc.h"
+
+/* The system call benchmark compares the fast svc path against the full
+ * one: it times get_proc_id, which takes the fast path, and a system
+ * call with an unused immediate, which takes the full path (i.e., saves
+ * and restores the whole context) to do nothing at all, then prints the
+ * cycles per call of each, less the cost of reading the cycle counter.
+ * get_proc_id does (a little) more work, so the saving is understated.
+ */
+
+#define BENCH_REPS 1024
+#define BENCH_NONE 0x3F             // unused, but below SVC_FAST
+
+// cycles taken by a back-to-back pair of reads of the cycle counter
+uint32_t bench_svc_overhead() {
+  uint32_t t = pmu_read( 0, PMU_EVENT_CYCLES );
+
+  return pmu_read( 0, PMU_EVENT_CYCLES ) - t;
+}
+
+void main_bench_svc() {
+  pmu_open( 0, PMU_EVENT_CYCLES );
+
+  uint32_t overhead = bench_svc_overhead();
+
+  uint32_t fast = pmu_read( 0, PMU_EVENT_CYCLES );
+
+  for( int i = 0; i < BENCH_REPS; i++ ) {
+    get_proc_id();
+  }
+
+  fast = ( pmu_read( 0, PMU_EVENT_CYCLES ) - fast - overhead ) / BENCH_REPS;
+
+  uint32_t full = pmu_read( 0, PMU_EVENT_CYCLES );
+
+  for( int i = 0; i < BENCH_REPS; i++ ) {
+    asm volatile( "svc %0 \n" // make system call BENCH_NONE
+                :
+                : "I" (BENCH_NONE)
+                : "r0", "memory" );
+  }
+
+  full = ( pmu_read( 0, PMU_EVENT_CYCLES ) - full - overhead ) / BENCH_REPS;
+
+  printf( "fast %5u full %5u (cycles per call)\n", fast, full );
+
+  pmu_close( 0, PMU_EVENT_CYCLES );
+
+  exit( EXIT_SUCCESS );
+}
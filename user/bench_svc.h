@@ -0,0 +1,10 @@
+#ifndef __BENCH_SVC_H
+#define __BENCH_SVC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "libc.h"
+
+#endif
@@ -13,7 +13,12 @@ void puts( char* x, int n ) {
 }
 
 void gets( char* x, int n ) {
+  pollfd_t fd = { POLL_CONSOLE, POLL_IN, 0 };
+
   for( int i = 0; i < n; i++ ) {
+    // sleep, rather than spin, until a character arrives
+    poll( &fd, 1, -1 );
+
     x[ i ] = PL011_getc( UART1, true );
 
     if( x[ i ] == '\x0A' ) {
@@ -23,32 +28,257 @@ void gets( char* x, int n ) {
   }
 }
 
+void puti( int x ) {
+  char r[ 12 ];
+
+  itoa( r, x );
+  puts( r, strlen( r ) );
+}
+
 /* Since we lack a *real* loader (as a result of lacking a storage
  * medium to store program images), the following approximates one:
  * given a program name, from the set of programs statically linked
- * into the kernel image, it returns a pointer to the entry point.
+ * into the kernel image, it returns a pointer to the entry point plus
+ * a hint as to how much stack the program needs.  Each hint is the
+ * worst-case usage (to be checked against the high-water mark reported
+ * by the stack command) plus 0x400 bytes of headroom, rounded up to a
+ * multiple of 0x400:
+ *
+ * - P3, P5: ~0x0D0 bytes, i.e., main, is_prime or weight, and fputs down
+ *           to write,
+ * - P4:     ~0x10D0 bytes, since gcd recurses once per subtraction, i.e.,
+ *           up to 255 frames of 16 bytes for operands in [16, 256),
+ * - waiter: ~0x190 bytes, i.e., printf via vfprintf, or cond_wait, and
+ * - bench_mem, bench_svc: ~0x1A0 bytes, i.e., printf via vfprintf.
  */
 
 extern void main_P3();
 extern void main_P4();
 extern void main_P5();
 extern void main_waiter();
+extern void main_bench_mem();
+extern void main_bench_svc();
 
-void* load( char* x ) {
+void* load( char* x, size_t* n ) {
   if     ( 0 == strcmp( x, "P3" ) ) {
-    return &main_P3;
+    *n = 0x0800; return &main_P3;
   }
   else if( 0 == strcmp( x, "P4" ) ) {
-    return &main_P4;
+    *n = 0x1800; return &main_P4;
   }
   else if( 0 == strcmp( x, "P5" ) ) {
-    return &main_P5;
+    *n = 0x0800; return &main_P5;
   }
   else if( 0 == strcmp( x, "waiter" ) ) {
-    return &main_waiter;
+    *n = 0x0800; return &main_waiter;
+  }
+  else if( 0 == strcmp( x, "bench_mem" ) ) {
+    *n = 0x0800; return &main_bench_mem;
+  }
+  else if( 0 == strcmp( x, "bench_svc" ) ) {
+    *n = 0x0800; return &main_bench_svc;
   }
 
-  return NULL;
+  *n = 0; return NULL;
+}
+
+/* The perf command either
+ *
+ * - runs  a program (as per fork) with performance counters opened on
+ *   the child before it execs, i.e., "perf run P3 5", or
+ * - shows the counters of an existing process,  i.e., "perf show 3".
+ */
+
+int perf_events[] = { PMU_EVENT_CYCLES, PMU_EVENT_INSTR, PMU_EVENT_L1D_REFILL, PMU_EVENT_BR_MISPRED };
+char* perf_names[] = { "cycles       ", "instructions ", "L1D refills  ", "br. mispred. " };
+
+void perf( char* x ) {
+  if      ( 0 == strcmp( x, "run"  ) ) {
+    size_t size;
+    void* addr   = load( strtok( NULL, " " ), &size );
+    int priority = atoi( strtok( NULL, " " ) );
+
+    pid_t pid = fork(priority);
+
+    if ( 0 == pid ) {
+      for( int i = 0; i < 4; i++ ) {
+        pmu_open( 0, perf_events[ i ] );
+      }
+
+      exec( addr, size );
+    }
+  }
+  else if ( 0 == strcmp( x, "show" ) ) {
+    pid_t pid = atoi( strtok( NULL, " " ) );
+
+    for( int i = 0; i < 4; i++ ) {
+      puts( perf_names[ i ], 13 ); puti( pmu_read( pid, perf_events[ i ] ) ); puts( "\n", 1 );
+    }
+  }
+  else {
+    puts( "unknown command\n", 16 );
+  }
+}
+
+/* The prof command controls the sampling profiler, i.e.,
+ *
+ * - "prof start 256" samples every 256 profiling timer ticks,
+ * - "prof stop"      stops sampling, and
+ * - "prof dump"      writes the histogram out for prof.py.
+ */
+
+void prof( char* x ) {
+  if      ( 0 == strcmp( x, "start" ) ) {
+    prof_start( atoi( strtok( NULL, " " ) ) );
+  }
+  else if ( 0 == strcmp( x, "stop"  ) ) {
+    prof_stop();
+  }
+  else if ( 0 == strcmp( x, "dump"  ) ) {
+    prof_dump();
+  }
+  else {
+    puts( "unknown command\n", 16 );
+  }
+}
+
+/* The stats command prints the kernel statistics, skipping any counter
+ * which is zero: the latency histogram is printed as one line per log2
+ * bucket, i.e., "< 2^i" counts dispatches after fewer than 2^i ticks.
+ */
+
+void show_stats() {
+  stats_t s;
+
+  stats( &s );
+
+  puts( "uptime   ", 9 ); puti( s.uptime      ); puts( " x 10ms\n", 8 );
+  puts( "switches ", 9 ); puti( s.switches    ); puts(       "\n", 1 );
+  puts( "pipe wr  ", 9 ); puti( s.pipe_writes ); puts(       "\n", 1 );
+  puts( "pipe rd  ", 9 ); puti( s.pipe_reads  ); puts(       "\n", 1 );
+  puts( "pipe nil ", 9 ); puti( s.pipe_empty  ); puts(       "\n", 1 );
+  puts( "rt miss  ", 9 ); puti( s.rt_misses   ); puts(       "\n", 1 );
+
+  for( int i = 0; i < STATS_IRQS; i++ ) {
+    if( s.irq[ i ] ) {
+      puts( "irq ", 4 ); puti( i ); puts( " ", 1 ); puti( s.irq[ i ] ); puts( "\n", 1 );
+    }
+  }
+  for( int i = 0; i < STATS_SVCS; i++ ) {
+    if( s.svc[ i ] ) {
+      puts( "svc ", 4 ); puti( i ); puts( " ", 1 ); puti( s.svc[ i ] ); puts( "\n", 1 );
+    }
+  }
+  for( int i = 0; i < STATS_BUCKETS; i++ ) {
+    if( s.latency[ i ] ) {
+      puts( "lat < 2^", 8 ); puti( i ); puts( " ", 1 ); puti( s.latency[ i ] ); puts( "\n", 1 );
+    }
+  }
+}
+
+/* The stack command prints the stack size and high-water mark of a
+ * process, i.e., "stack 3", flagging any overflow of the guard word.
+ */
+
+void show_stack( pid_t pid ) {
+  stack_stat_t s;
+
+  if( stack_stat( pid, &s ) < 0 ) {
+    puts( "unknown process\n", 16 );
+    return;
+  }
+
+  puts( "size ", 5 ); puti( s.size ); puts( "\n", 1 );
+  puts( "used ", 5 ); puti( s.used ); puts( "\n", 1 );
+
+  if( s.overflow ) {
+    puts( "overflow\n", 9 );
+  }
+}
+
+/* The kmem command prints kernel memory usage, i.e., live and peak
+ * bytes plus a per-type and per-call-site breakdown, or, as "kmem leaks",
+ * has the kernel list objects owned by exited processes or closed pipes.
+ */
+
+char* kmem_names[] = { "ring ", "node ", "ctx  ", "pcb  ", "pipe " };
+
+void show_kmem( char* x ) {
+  if( x != NULL && 0 == strcmp( x, "leaks" ) ) {
+    puts( "leaks ", 6 ); puti( kmem_leaks() ); puts( "\n", 1 );
+    return;
+  }
+
+  kmem_stat_t s;
+
+  kmem_stat( &s );
+
+  puts( "live ", 5 ); puti( s.live ); puts( "\n", 1 );
+  puts( "peak ", 5 ); puti( s.peak ); puts( "\n", 1 );
+
+  for( int i = 0; i < KMEM_TYPES; i++ ) {
+    puts( kmem_names[ i ], 5 ); puti( s.allocs[ i ] ); puts( " allocs ", 8 );
+                                puti( s.frees[  i ] ); puts( " frees ",  7 );
+                                puti( s.bytes[  i ] ); puts( " bytes\n", 7 );
+  }
+  for( int i = 0; i < KMEM_SITES; i++ ) {
+    if( s.site_bytes[ i ] ) {
+      char r[ 8 ];
+
+      for( int j = 0; j < 8; j++ ) {
+        r[ j ] = "0123456789ABCDEF"[ ( s.site[ i ] >> ( 28 - 4 * j ) ) & 0xF ];
+      }
+
+      puts( "site ", 5 ); puts( r, 8 ); puts( " ", 1 ); puti( s.site_bytes[ i ] ); puts( "\n", 1 );
+    }
+  }
+}
+
+/* The sched command switches the scheduling policy, i.e., "sched mlfq"
+ * or "sched priority", st. both can be compared without rebuilding.
+ */
+
+void sched( char* x ) {
+  int policy = -1;
+
+  if      ( x != NULL && 0 == strcmp( x, "priority" ) ) {
+    policy = SCHED_PRIORITY;
+  }
+  else if ( x != NULL && 0 == strcmp( x, "mlfq"     ) ) {
+    policy = SCHED_MLFQ;
+  }
+
+  if( sched_policy( policy ) < 0 ) {
+    puts( "unknown policy\n", 15 );
+  }
+}
+
+/* The group command manages CPU bandwidth, i.e.,
+ *
+ * - "group new 2 8"  creates a group limited to 2 ticks in every 8,
+ *   printing its id, and
+ * - "group move 3 1" moves process 3 (and its future children) into
+ *   group 1, where group 0 is the unlimited group the console is in.
+ */
+
+void group( char* x ) {
+  if      ( 0 == strcmp( x, "new"  ) ) {
+    uint32_t quota  = atoi( strtok( NULL, " " ) );
+    uint32_t period = atoi( strtok( NULL, " " ) );
+
+    puti( group_create( quota, period ) ); puts( "\n", 1 );
+  }
+  else if ( 0 == strcmp( x, "move" ) ) {
+    pid_t pid = atoi( strtok( NULL, " " ) );
+    int   id  = atoi( strtok( NULL, " " ) );
+
+    if( group_move( pid, id ) < 0 ) {
+      puts( "unknown group\n", 14 );
+    }
+  }
+  else {
+    puts( "unknown command\n", 16 );
+  }
 }
 
 /* The behaviour of the console process can be summarised as an
@@ -57,31 +287,62 @@ void* load( char* x ) {
  * 1. write a command prompt then read a command,
  * 2. split the command into space-separated tokens using strtok,
  * 3. execute whatever steps the command dictates.
+ *
+ * Before each prompt, any children which exited are waited for, st. the
+ * kernel can release them.
  */
 
 void main_console() {
   char* p, x[ 1024 ];
+  int   status;
 
   while( 1 ) {
+    while( waitpid( -1, &status, WAIT_NOHANG ) > 0 ) {
+    }
+
     puts( "shell$ ", 7 );
     gets( x, 1024 );
     p = strtok( x, " " );
 
     if ( 0 == strcmp( p, "fork" ) ) {
-      void* addr   = load( strtok( NULL, " " ) );
+      size_t size;
+      void* addr   = load( strtok( NULL, " " ), &size );
       int priority = atoi( strtok( NULL, " " ) );
+      char* count  = strtok( NULL, " " );
 
-      pid_t pid = fork(priority);
-
-      if ( 0 == pid ) {
-        exec( addr );
-      }
+      spawn( addr, priority, size, ( count != NULL ) ? atoi( count ) : 1 );
+    }
+    else if ( 0 == strcmp( p, "perf" ) ) {
+      perf( strtok( NULL, " " ) );
+    }
+    else if ( 0 == strcmp( p, "prof" ) ) {
+      prof( strtok( NULL, " " ) );
+    }
+    else if ( 0 == strcmp( p, "stats" ) ) {
+      show_stats();
+    }
+    else if ( 0 == strcmp( p, "stack" ) ) {
+      show_stack( atoi( strtok( NULL, " " ) ) );
+    }
+    else if ( 0 == strcmp( p, "kmem" ) ) {
+      show_kmem( strtok( NULL, " " ) );
+    }
+    else if ( 0 == strcmp( p, "sched" ) ) {
+      sched( strtok( NULL, " " ) );
+    }
+    else if ( 0 == strcmp( p, "group" ) ) {
+      group( strtok( NULL, " " ) );
     }
     else if ( 0 == strcmp( p, "kill" ) ) {
       pid_t pid = atoi( strtok( NULL, " " ) );
       int   s   = atoi( strtok( NULL, " " ) );
 
-      kill( pid, s );
+      if( kill( pid, s ) < 0 ) {
+        puts( "unknown process\n", 16 );
+      }
+      else {
+        waitpid( pid, &status, 0 );
+      }
     }
     else {
       puts( "unknown command\n", 16 );
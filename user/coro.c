@@ -0,0 +1,185 @@
+#include "coro.h"
+
+// switch from the running context to the one with stack pointer sp
+extern void coro_switch(uint32_t* save, uint32_t sp);
+// first code executed by each task: passes r4 (i.e., the task) to coro_start
+extern void coro_entry();
+
+void coro_push(coro_sched_t* s, coro_t* c) {
+  c->next = NULL;
+
+  if (s->tail == NULL) {
+    s->head = c;
+  }
+  else {
+    s->tail->next = c;
+  }
+
+  s->tail = c;
+}
+
+coro_t* coro_pop(coro_sched_t* s) {
+  coro_t* c = s->head;
+
+  s->head = c->next;
+
+  if (s->head == NULL) {
+    s->tail = NULL;
+  }
+
+  return c;
+}
+
+// executed by each task, via the frame built by coro_create
+void coro_start(coro_t* c) {
+  c->f(c->arg);
+
+  c->state = CORO_DONE;
+  coro_switch(&c->sp, c->sched->main_sp);
+}
+
+void coro_init(coro_sched_t* s) {
+  s->current = NULL;
+  s->main_sp = 0;
+  s->head    = NULL;
+  s->tail    = NULL;
+  s->waiting = NULL;
+}
+
+void coro_create(coro_sched_t* s, coro_t* c, void (*f)(void*), void* arg, void* x, size_t n) {
+  // align the top of stack (per AAPCS), then build a frame as saved by
+  // coro_switch, i.e., r4-r11 (with r4 = the task) then the return address
+  // (plus d8-d15 below them, if the VFP may be used)
+  uint32_t* sp = (uint32_t*) (((uint32_t) x + n) & ~0x7);
+
+  *--sp = (uint32_t) &coro_entry;
+
+  for (int i = 0; i < 7; i++) {
+    *--sp = 0;
+  }
+
+  *--sp = (uint32_t) c;
+
+#ifdef __ARM_FP
+  for (int i = 0; i < 16; i++) {
+    *--sp = 0;
+  }
+#endif
+
+  c->sp    = (uint32_t) sp;
+  c->state = CORO_READY;
+  c->f     = f;
+  c->arg   = arg;
+  c->sched = s;
+
+  coro_push(s, c);
+}
+
+// poll the descriptors waited for, moving tasks whose descriptor is ready
+// onto the run queue
+void coro_poll(coro_sched_t* s, int timeout) {
+  pollfd_t fds[CORO_POLL_MAX];
+  coro_t*  cs[CORO_POLL_MAX];
+  int      n = 0;
+
+  for (coro_t* c = s->waiting; c != NULL && n < CORO_POLL_MAX; c = c->next) {
+    fds[n] = c->wait;
+    cs[n++] = c;
+  }
+
+  poll(fds, n, timeout);
+
+  coro_t** prev = &s->waiting;
+
+  for (int i = 0; i < n; i++) {
+    // the waiting list is in the order polled, so find each task in turn
+    while (*prev != cs[i]) {
+      prev = &(*prev)->next;
+    }
+
+    if (fds[i].revents != 0) {
+      *prev = cs[i]->next;
+
+      cs[i]->wait.revents = fds[i].revents;
+      cs[i]->state        = CORO_READY;
+      coro_push(s, cs[i]);
+    }
+    else {
+      prev = &cs[i]->next;
+    }
+  }
+
+  // rotate any tasks beyond the batch to the front, st. each is polled in turn
+  if (*prev != NULL && prev != &s->waiting) {
+    coro_t* rest = *prev;
+    coro_t* last = rest;
+
+    while (last->next != NULL) {
+      last = last->next;
+    }
+
+    *prev      = NULL;
+    last->next = s->waiting;
+    s->waiting = rest;
+  }
+}
+
+void coro_run(coro_sched_t* s) {
+  while (s->head != NULL || s->waiting != NULL) {
+    if (s->head == NULL) {
+      int n = 0;
+
+      for (coro_t* c = s->waiting; c != NULL; c = c->next) {
+        n++;
+      }
+
+      coro_poll(s, (n > CORO_POLL_MAX) ? 1 : -1);
+      continue;
+    }
+
+    s->current = coro_pop(s);
+    coro_switch(&s->main_sp, s->current->sp);
+
+    if (s->current->state == CORO_READY) {
+      coro_push(s, s->current);
+    }
+    else if (s->current->state == CORO_WAITING) {
+      s->current->next = s->waiting;
+      s->waiting       = s->current;
+    }
+  }
+
+  s->current = NULL;
+}
+
+void coro_yield(coro_sched_t* s) {
+  s->current->state = CORO_READY;
+  coro_switch(&s->current->sp, s->main_sp);
+}
+
+int  coro_wait(coro_sched_t* s, int fd, int events) {
+  coro_t* c = s->current;
+
+  c->wait.fd      = fd;
+  c->wait.events  = events;
+  c->wait.revents = 0;
+
+  c->state = CORO_WAITING;
+  coro_switch(&c->sp, s->main_sp);
+
+  return c->wait.revents;
+}
+
+int  coro_read_pipe(coro_sched_t* s, int id) {
+  int r;
+
+  while ((r = _read_pipe(id)) == -1) {
+    coro_wait(s, id, POLL_IN);
+  }
+
+  return r;
+}
+
+coro_t* coro_self(coro_sched_t* s) {
+  return s->current;
+}
@@ -0,0 +1,71 @@
+#ifndef __CORO_H
+#define __CORO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "libc.h"
+
+/* Coroutines are stackful tasks scheduled cooperatively within a single
+ * process: each runs on a stack supplied by its creator until it yields,
+ * waits or returns, at which point a context switch written in assembly
+ * (see coro.S) returns to coro_run, which resumes the next ready task in
+ * FIFO order.  Switching therefore costs a handful of instructions rather
+ * than a system call and a pass of the kernel scheduler.
+ *
+ * A task may wait for a pipe or the console UART to become ready: once
+ * no task is ready, coro_run blocks in a single poll over (up to
+ * CORO_POLL_MAX of) the descriptors waited for.  If more are waited for
+ * than fit, it polls batches of them in turn with a timeout of 1 tick.
+ *
+ * Lacking per-process address spaces, any global state would be shared
+ * by every process, so the run queue and waiting list live in a scheduler
+ * owned by the caller, which each task points back to: any number of
+ * processes (or threads) may each run their own.
+ */
+
+#define CORO_READY    0
+#define CORO_WAITING  1
+#define CORO_DONE     2
+
+#define CORO_POLL_MAX 32
+
+typedef struct coro {
+  uint32_t           sp;             // saved stack pointer, while not running
+  int                state;
+  void             (*f)(void*);
+  void*              arg;
+  pollfd_t           wait;           // descriptor waited for, while waiting
+  struct coro*       next;           // next in run queue, or waiting list
+  struct coro_sched* sched;          // scheduler the task belongs to
+} coro_t;
+
+typedef struct coro_sched {
+  coro_t*  current;                  // running task, or NULL
+  uint32_t main_sp;                  // saved stack pointer of coro_run
+  coro_t*  head;                     // run queue
+  coro_t*  tail;
+  coro_t*  waiting;                  // waiting list
+} coro_sched_t;
+
+// initialise scheduler s, with no tasks
+extern void coro_init(coro_sched_t* s);
+// create a task of scheduler s executing f(arg) on the n-byte stack x
+extern void coro_create(coro_sched_t* s, coro_t* c, void (*f)(void*), void* arg, void* x, size_t n);
+
+// run the tasks of scheduler s until every one has returned
+extern void coro_run(coro_sched_t* s);
+
+// give up the processor to the next ready task of scheduler s
+extern void coro_yield(coro_sched_t* s);
+// wait until descriptor fd is ready for events; return those ready
+extern int  coro_wait(coro_sched_t* s, int fd, int events);
+
+// read from pipe id, waiting (rather than blocking the process) until there is data
+extern int  coro_read_pipe(coro_sched_t* s, int id);
+
+// return the running task of scheduler s
+extern coro_t* coro_self(coro_sched_t* s);
+
+#endif
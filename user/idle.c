@@ -0,0 +1,12 @@
+#include "idle.h"
+
+/* Each core runs an idle process whenever it has nothing else to do:
+ * rather than spin, it waits for an interrupt (e.g., the next timer
+ * tick, or a request to reschedule from another core).
+ */
+
+void main_idle() {
+  while( 1 ) {
+    asm volatile( "wfi \n" );
+  }
+}
@@ -0,0 +1,10 @@
+#ifndef __IDLE_H
+#define __IDLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "libc.h"
+
+#endif
@@ -98,6 +98,8 @@ int  fork(int priority) {
 }
 
 void exit(int x) {
+  stdio_exit();
+
   asm volatile( "mov r0, %1 \n" // assign r0 =  x
                 "svc %0     \n" // make system call SYS_EXIT
               :
@@ -107,16 +109,78 @@ void exit(int x) {
   return;
 }
 
-void exec(const void* x) {
+void exec(const void* x, size_t n) {
   asm volatile( "mov r0, %1 \n" // assign r0 = x
+                "mov r1, %2 \n" // assign r1 = n
                 "svc %0     \n" // make system call SYS_EXEC
               :
-              : "I" (SYS_EXEC), "r" (x)
-              : "r0" );
+              : "I" (SYS_EXEC), "r" (x), "r" (n)
+              : "r0", "r1" );
 
   return;
 }
 
+int  spawn(const void* x, int priority, size_t n, int count) {
+  int r;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 =    x
+                "mov r1, %3 \n" // assign r1 = priority
+                "mov r2, %4 \n" // assign r2 =    n
+                "mov r3, %5 \n" // assign r3 = count
+                "svc %1     \n" // make system call SYS_SPAWN
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_SPAWN), "r" (x), "r" (priority), "r" (n), "r" (count)
+              : "r0", "r1", "r2", "r3" );
+
+  return r;
+}
+
+void _thread_start(int (*f)(void*), void* arg) {
+  exit(f(arg));
+}
+
+int  thread_create(int (*f)(void*), void* arg, size_t n) {
+  int r;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 = _thread_start
+                "mov r1, %3 \n" // assign r1 =    f
+                "mov r2, %4 \n" // assign r2 =  arg
+                "mov r3, %5 \n" // assign r3 =    n
+                "svc %1     \n" // make system call SYS_THREAD_NEW
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_THREAD_NEW), "r" (&_thread_start), "r" (f), "r" (arg), "r" (n)
+              : "r0", "r1", "r2", "r3" );
+
+  return r;
+}
+
+int  _thread_join(int tid, int* x) {
+  int r;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 =  tid
+                "mov r1, %3 \n" // assign r1 =    x
+                "svc %1     \n" // make system call SYS_THREAD_JOIN
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_THREAD_JOIN), "r" (tid), "r" (x)
+              : "r0", "r1", "memory" );
+
+  return r;
+}
+
+int  thread_join(int tid, int* x) {
+  int r;
+
+  // the kernel blocks the caller until the thread exits, then it joins again
+  do {
+    r = _thread_join(tid, x);
+  } while (r == THREAD_AGAIN);
+
+  return r;
+}
+
 int  kill(int pid, int x) {
   int r;
 
@@ -131,6 +195,88 @@ int  kill(int pid, int x) {
   return r;
 }
 
+int  _waitpid(pid_t pid, int* x, int flags) {
+  int r;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 =  pid
+                "mov r1, %3 \n" // assign r1 =    x
+                "mov r2, %4 \n" // assign r2 = flags
+                "svc %1     \n" // make system call SYS_WAITPID
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_WAITPID), "r" (pid), "r" (x), "r" (flags)
+              : "r0", "r1", "r2", "memory" );
+
+  return r;
+}
+
+int  waitpid(pid_t pid, int* x, int flags) {
+  int r;
+
+  // the kernel blocks the caller until a child exits, then it waits again
+  do {
+    r = _waitpid(pid, x, flags);
+  } while (r == WAIT_AGAIN);
+
+  return r;
+}
+
+// placed on its own page by the linker script, and written by the kernel
+extern const clock_page_t clock_page;
+
+int  _clock_gettime(int id, timespec_t* t) {
+  int r;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 =   id
+                "mov r1, %3 \n" // assign r1 =    t
+                "svc %1     \n" // make system call SYS_CLOCK_GETTIME
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_CLOCK_GETTIME), "r" (id), "r" (t)
+              : "r0", "r1", "memory" );
+
+  return r;
+}
+
+uint64_t clock_ticks() {
+  volatile const clock_page_t* page = &clock_page;
+  uint32_t seq, wraps, last, now;
+
+  // retry if the kernel updated the page meanwhile
+  do {
+    seq   = page->seq;
+    __sync_synchronize();
+    wraps = page->wraps;
+    last  = page->last;
+    now   = ~*page->counter;
+    __sync_synchronize();
+  } while ((seq & 1) || seq != page->seq);
+
+  // the counter may have wrapped since the last update
+  if (now < last) {
+    wraps++;
+  }
+
+  return ((uint64_t) wraps << 32) | now;
+}
+
+uint32_t clock_hz() {
+  return clock_page.hz;
+}
+
+int  clock_gettime(int id, timespec_t* t) {
+  if (id != CLOCK_MONOTONIC) {
+    return _clock_gettime(id, t);
+  }
+
+  uint64_t x = clock_ticks();
+
+  t->sec  = x / clock_page.hz;
+  t->nsec = (x % clock_page.hz) * (1000000000 / clock_page.hz);
+
+  return 0;
+}
+
 int  open_pipe(pid_t pid1, pid_t pid2) {
   int r;
 
@@ -186,18 +332,12 @@ int  _read_pipe(int id) {
 
 void write_pipe(int id, int x) {
   _write_pipe(id, x);
-  yield();
-
-  // loop checking the pipe until another process reads from it
-  int read_from = 0;
-  while (read_from == 0) {
-    // only check value of pipe, don't overwrite it
-    read_from = _check_pipe(id, x);
-    // if pipe has not been read from, yield to give other processes a chance
-    if (read_from == 0) {
-      yield();
-    }
-  }
+
+  // wait until another process reads from the pipe, i.e., it is empty
+  pollfd_t fd = { id, POLL_OUT, 0 };
+  do {
+    poll(&fd, 1, -1);
+  } while (!(fd.revents & (POLL_OUT | POLL_ERR)));
 }
 
 int  read_pipe(int id) {
@@ -205,14 +345,41 @@ int  read_pipe(int id) {
   int response = -1;
   while (response == -1) {
     response = _read_pipe( id );
-    // if pipe has not been written to, yield to give other processes a chance
+    // if pipe has not been written to, wait until it is
     if (response == -1) {
-      yield();
+      pollfd_t fd = { id, POLL_IN, 0 };
+      poll(&fd, 1, -1);
     }
   }
   return response;
 }
 
+int  _poll(pollfd_t* fds, int n, int timeout) {
+  int r;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 =  fds
+                "mov r1, %3 \n" // assign r1 =    n
+                "mov r2, %4 \n" // assign r2 = timeout
+                "svc %1     \n" // make system call SYS_POLL
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_POLL), "r" (fds), "r" (n), "r" (timeout)
+              : "r0", "r1", "r2", "memory" );
+
+  return r;
+}
+
+int  poll(pollfd_t* fds, int n, int timeout) {
+  int r;
+
+  // the kernel resumes the timeout of a poll cut short, so just poll again
+  do {
+    r = _poll(fds, n, timeout);
+  } while (r == POLL_AGAIN);
+
+  return r;
+}
+
 void close_pipe(int id) {
   asm volatile( "mov r0, %1 \n" // assign r0 =  id
                 "svc %0     \n" // make system call SYS_KILL
@@ -234,3 +401,803 @@ int  get_proc_id() {
 
   return r;
 }
+
+int  pmu_open(pid_t pid, int x) {
+  int r;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 =  pid
+                "mov r1, %3 \n" // assign r1 =    x
+                "svc %1     \n" // make system call SYS_PMU_OPEN
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_PMU_OPEN), "r" (pid), "r" (x)
+              : "r0", "r1" );
+
+  return r;
+}
+
+uint32_t pmu_read(pid_t pid, int x) {
+  uint32_t r;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 =  pid
+                "mov r1, %3 \n" // assign r1 =    x
+                "svc %1     \n" // make system call SYS_PMU_READ
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_PMU_READ), "r" (pid), "r" (x)
+              : "r0", "r1" );
+
+  return r;
+}
+
+void pmu_close(pid_t pid, int x) {
+  asm volatile( "mov r0, %1 \n" // assign r0 =  pid
+                "mov r1, %2 \n" // assign r1 =    x
+                "svc %0     \n" // make system call SYS_PMU_CLOSE
+              :
+              : "I" (SYS_PMU_CLOSE), "r" (pid), "r" (x)
+              : "r0", "r1" );
+
+  return;
+}
+
+void prof_start(uint32_t x) {
+  asm volatile( "mov r0, %1 \n" // assign r0 =    x
+                "svc %0     \n" // make system call SYS_PROF_START
+              :
+              : "I" (SYS_PROF_START), "r" (x)
+              : "r0" );
+
+  return;
+}
+
+void prof_stop() {
+  asm volatile( "svc %0     \n" // make system call SYS_PROF_STOP
+              :
+              : "I" (SYS_PROF_STOP)
+              : );
+
+  return;
+}
+
+void prof_dump() {
+  asm volatile( "svc %0     \n" // make system call SYS_PROF_DUMP
+              :
+              : "I" (SYS_PROF_DUMP)
+              : );
+
+  return;
+}
+
+void stats(stats_t* x) {
+  asm volatile( "mov r0, %1 \n" // assign r0 =    x
+                "svc %0     \n" // make system call SYS_STATS
+              :
+              : "I" (SYS_STATS), "r" (x)
+              : "r0", "memory" );
+
+  return;
+}
+
+int  stack_stat(pid_t pid, stack_stat_t* x) {
+  int r;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 =  pid
+                "mov r1, %3 \n" // assign r1 =    x
+                "svc %1     \n" // make system call SYS_STACK_STAT
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_STACK_STAT), "r" (pid), "r" (x)
+              : "r0", "r1", "memory" );
+
+  return r;
+}
+
+void kmem_stat(kmem_stat_t* x) {
+  asm volatile( "mov r0, %1 \n" // assign r0 =    x
+                "svc %0     \n" // make system call SYS_KMEM_STAT
+              :
+              : "I" (SYS_KMEM_STAT), "r" (x)
+              : "r0", "memory" );
+
+  return;
+}
+
+int  kmem_leaks() {
+  int r;
+
+  asm volatile( "svc %1     \n" // make system call SYS_KMEM_LEAKS
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_KMEM_LEAKS)
+              : "r0" );
+
+  return r;
+}
+
+int  sched_rt(uint32_t period, uint32_t budget, uint32_t deadline) {
+  int r;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 =   period
+                "mov r1, %3 \n" // assign r1 =   budget
+                "mov r2, %4 \n" // assign r2 = deadline
+                "svc %1     \n" // make system call SYS_SCHED_RT
+                "mov %0, r0 \n" // assign r  =       r0
+              : "=r" (r)
+              : "I" (SYS_SCHED_RT), "r" (period), "r" (budget), "r" (deadline)
+              : "r0", "r1", "r2" );
+
+  return r;
+}
+
+int  sched_policy(int x) {
+  int r;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 =    x
+                "svc %1     \n" // make system call SYS_SCHED_POLICY
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_SCHED_POLICY), "r" (x)
+              : "r0" );
+
+  return r;
+}
+
+int  rt_misses(pid_t pid) {
+  int r;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 =  pid
+                "svc %1     \n" // make system call SYS_RT_MISSES
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_RT_MISSES), "r" (pid)
+              : "r0" );
+
+  return r;
+}
+
+int  group_create(uint32_t quota, uint32_t period) {
+  int r;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 =  quota
+                "mov r1, %3 \n" // assign r1 = period
+                "svc %1     \n" // make system call SYS_GROUP_NEW
+                "mov %0, r0 \n" // assign r  =     r0
+              : "=r" (r)
+              : "I" (SYS_GROUP_NEW), "r" (quota), "r" (period)
+              : "r0", "r1" );
+
+  return r;
+}
+
+int  group_move(pid_t pid, int id) {
+  int r;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 =  pid
+                "mov r1, %3 \n" // assign r1 =   id
+                "svc %1     \n" // make system call SYS_GROUP_MOVE
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_GROUP_MOVE), "r" (pid), "r" (id)
+              : "r0", "r1" );
+
+  return r;
+}
+
+int  chan_open() {
+  int r;
+
+  asm volatile( "svc %1     \n" // make system call SYS_CHAN_OPEN
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_CHAN_OPEN)
+              : "r0" );
+
+  return r;
+}
+
+int  chan_close(int id) {
+  int r;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 =   id
+                "svc %1     \n" // make system call SYS_CHAN_CLOSE
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_CHAN_CLOSE), "r" (id)
+              : "r0" );
+
+  return r;
+}
+
+int  chan_subscribe(int id) {
+  int r;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 =   id
+                "svc %1     \n" // make system call SYS_CHAN_SUB
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_CHAN_SUB), "r" (id)
+              : "r0" );
+
+  return r;
+}
+
+int  chan_publish(int id, int x) {
+  int r;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 =   id
+                "mov r1, %3 \n" // assign r1 =    x
+                "svc %1     \n" // make system call SYS_CHAN_PUB
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_CHAN_PUB), "r" (id), "r" (x)
+              : "r0", "r1" );
+
+  return r;
+}
+
+int  _chan_read(int id, int* x) {
+  int r;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 =   id
+                "mov r1, %3 \n" // assign r1 =    x
+                "svc %1     \n" // make system call SYS_CHAN_READ
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_CHAN_READ), "r" (id), "r" (x)
+              : "r0", "r1", "memory" );
+
+  return r;
+}
+
+int  chan_read(int id, int* x) {
+  int r;
+
+  // the kernel blocks the caller until the next publish, then it reads again
+  do {
+    r = _chan_read(id, x);
+  } while (r == CHAN_AGAIN);
+
+  return r;
+}
+
+int  uring_setup(uring_t* x, uint32_t f) {
+  int r;
+
+  x->flags = f;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 =    x
+                "svc %1     \n" // make system call SYS_URING_SETUP
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_URING_SETUP), "r" (x)
+              : "r0", "memory" );
+
+  return r;
+}
+
+uring_sqe_t* uring_get_sqe(uring_t* x) {
+  if (x->sq_tail - x->sq_head == URING_ENTRIES) {
+    return NULL;
+  }
+
+  return &x->sq[x->sq_tail % URING_ENTRIES];
+}
+
+void uring_queue(uring_t* x) {
+  // the entry must be visible before the tail which publishes it
+  asm volatile( "dmb \n" : : : "memory" );
+
+  x->sq_tail++;
+}
+
+bool _uring_pollable(uring_t* x) {
+  for (uint32_t i = x->sq_head; i != x->sq_tail; i++) {
+    uint32_t op = x->sq[i % URING_ENTRIES].op;
+
+    if (op != URING_NOP && op != URING_PIPE_WRITE && op != URING_PIPE_READ) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+int  uring_submit(uring_t* x) {
+  int r;
+
+  // the kernel leaves console and disk entries (and any after them) for
+  // uring_enter, so only skip the system call if there are none queued
+  if ((x->flags & URING_SQPOLL) && _uring_pollable(x)) {
+    return 0;
+  }
+
+  asm volatile( "svc %1     \n" // make system call SYS_URING_ENTER
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_URING_ENTER)
+              : "r0", "memory" );
+
+  return r;
+}
+
+uring_cqe_t* uring_peek_cqe(uring_t* x) {
+  if (x->cq_head == x->cq_tail) {
+    return NULL;
+  }
+
+  // the entry must be read after the tail which published it
+  asm volatile( "dmb \n" : : : "memory" );
+
+  return &x->cq[x->cq_head % URING_ENTRIES];
+}
+
+uring_cqe_t* uring_wait_cqe(uring_t* x) {
+  uint32_t head = x->cq_head;
+
+  while (x->cq_tail == head) {
+    futex_wait((volatile int*) &x->cq_tail, head);
+  }
+
+  return uring_peek_cqe(x);
+}
+
+void uring_cqe_seen(uring_t* x) {
+  x->cq_head++;
+}
+
+int  shm_create(size_t n) {
+  int r;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 =    n
+                "svc %1     \n" // make system call SYS_SHM_CREATE
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_SHM_CREATE), "r" (n)
+              : "r0" );
+
+  return r;
+}
+
+void* shm_attach(int id) {
+  void* r;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 =   id
+                "svc %1     \n" // make system call SYS_SHM_ATTACH
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_SHM_ATTACH), "r" (id)
+              : "r0" );
+
+  return r;
+}
+
+int  shm_detach(int id) {
+  int r;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 =   id
+                "svc %1     \n" // make system call SYS_SHM_DETACH
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_SHM_DETACH), "r" (id)
+              : "r0", "memory" );
+
+  return r;
+}
+
+int  atomic_cas(volatile int* x, int c, int y) {
+  int r, t;
+
+  asm volatile( "   dmb                    \n" // order wrt. earlier accesses
+                "1: ldrex   %0, [ %2 ]     \n" // load   r = *x, marking x exclusive
+                "   cmp     %0, %3         \n" // bail out iff. r != c
+                "   bne     2f             \n"
+                "   strex   %1, %4, [ %2 ] \n" // store *x = y iff. x still exclusive
+                "   cmp     %1, #0         \n" // retry iff. the store failed
+                "   bne     1b             \n"
+                "2: dmb                    \n" // order wrt. later accesses
+              : "=&r" (r), "=&r" (t)
+              : "r" (x), "r" (c), "r" (y)
+              : "cc", "memory" );
+
+  return r;
+}
+
+int  atomic_swap(volatile int* x, int y) {
+  int r, t;
+
+  asm volatile( "   dmb                    \n" // order wrt. earlier accesses
+                "1: ldrex   %0, [ %2 ]     \n" // load   r = *x, marking x exclusive
+                "   strex   %1, %3, [ %2 ] \n" // store *x = y iff. x still exclusive
+                "   cmp     %1, #0         \n" // retry iff. the store failed
+                "   bne     1b             \n"
+                "   dmb                    \n" // order wrt. later accesses
+              : "=&r" (r), "=&r" (t)
+              : "r" (x), "r" (y)
+              : "cc", "memory" );
+
+  return r;
+}
+
+int  atomic_add(volatile int* x, int y) {
+  int r, t, u;
+
+  asm volatile( "   dmb                    \n" // order wrt. earlier accesses
+                "1: ldrex   %0, [ %3 ]     \n" // load   r = *x, marking x exclusive
+                "   add     %2, %0, %4     \n" //        u = r + y
+                "   strex   %1, %2, [ %3 ] \n" // store *x = u iff. x still exclusive
+                "   cmp     %1, #0         \n" // retry iff. the store failed
+                "   bne     1b             \n"
+                "   dmb                    \n" // order wrt. later accesses
+              : "=&r" (r), "=&r" (t), "=&r" (u)
+              : "r" (x), "r" (y)
+              : "cc", "memory" );
+
+  return r;
+}
+
+int  futex_wait(volatile int* x, int v) {
+  int r;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 =    x
+                "mov r1, %3 \n" // assign r1 =    v
+                "svc %1     \n" // make system call SYS_FUTEX_WAIT
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_FUTEX_WAIT), "r" (x), "r" (v)
+              : "r0", "r1", "memory" );
+
+  return r;
+}
+
+int  futex_wake(volatile int* x, int n) {
+  int r;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 =    x
+                "mov r1, %3 \n" // assign r1 =    n
+                "svc %1     \n" // make system call SYS_FUTEX_WAKE
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_FUTEX_WAKE), "r" (x), "r" (n)
+              : "r0", "r1", "memory" );
+
+  return r;
+}
+
+int  futex_wait_pi(volatile int* x, int v) {
+  int r;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 =    x
+                "mov r1, %3 \n" // assign r1 =    v
+                "svc %1     \n" // make system call SYS_FUTEX_WAIT_PI
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_FUTEX_WAIT_PI), "r" (x), "r" (v)
+              : "r0", "r1", "memory" );
+
+  return r;
+}
+
+/* A mutex is 0 if unlocked, or else the pid of the holder, plus the flag
+ * MUTEX_WAITERS if there are (possibly) blocked processes: only a lock
+ * which finds it locked, or an unlock which finds the flag set, makes a
+ * system call.  Since the kernel can tell the holder from the value, it
+ * has the holder inherit the priority of each blocked process.
+ */
+
+void mutex_lock(mutex_t* x) {
+  pid_t self = get_self();
+
+  if (atomic_cas(&x->value, 0, self) == 0) {
+    return;
+  }
+
+  while (1) {
+    int c = x->value;
+
+    // once contended, keep the flag set: there may be others still blocked
+    if (c == 0) {
+      if (atomic_cas(&x->value, 0, self | MUTEX_WAITERS) == 0) {
+        return;
+      }
+      continue;
+    }
+
+    // mark the mutex as contended, then block until it is unlocked
+    if (!(c & MUTEX_WAITERS) && atomic_cas(&x->value, c, c | MUTEX_WAITERS) != c) {
+      continue;
+    }
+
+    futex_wait_pi(&x->value, c | MUTEX_WAITERS);
+  }
+}
+
+void mutex_unlock(mutex_t* x) {
+  pid_t self = get_self();
+
+  if (atomic_cas(&x->value, self, 0) != self) {
+    atomic_swap(&x->value, 0);
+    futex_wake(&x->value, 1);
+  }
+}
+
+bool mutex_trylock(mutex_t* x) {
+  return atomic_cas(&x->value, 0, get_self()) == 0;
+}
+
+void sem_init(sem_t* x, int n) {
+  x->value   = n;
+  x->waiters = 0;
+}
+
+void sem_wait(sem_t* x) {
+  while (1) {
+    int c = x->value;
+
+    if (c > 0) {
+      if (atomic_cas(&x->value, c, c - 1) == c) {
+        return;
+      }
+      continue;
+    }
+
+    atomic_add(&x->waiters, 1);
+    futex_wait(&x->value, 0);
+    atomic_add(&x->waiters, -1);
+  }
+}
+
+void sem_post(sem_t* x) {
+  atomic_add(&x->value, 1);
+
+  if (x->waiters > 0) {
+    futex_wake(&x->value, 1);
+  }
+}
+
+void cond_wait(cond_t* x, mutex_t* m) {
+  int c = x->seq;
+
+  mutex_unlock(m);
+  futex_wait(&x->seq, c);
+
+  mutex_lock(m);
+}
+
+void cond_signal(cond_t* x) {
+  atomic_add(&x->seq, 1);
+  futex_wake(&x->seq, 1);
+}
+
+void cond_broadcast(cond_t* x) {
+  atomic_add(&x->seq, 1);
+  futex_wake(&x->seq, 0x7FFFFFFF);
+}
+
+pid_t get_self() {
+  pid_t r;
+
+  asm volatile( "mrc p15, 0, %0, c13, c0, 3 \n" // read TPIDRURO
+              : "=r" (r)
+              :
+              : );
+
+  return r;
+}
+
+int  _stdio_claim(stdio_buf_t* x) {
+  int r;
+
+  asm volatile( "mov r0, %2 \n" // assign r0 =    x
+                "svc %1     \n" // make system call SYS_STDIO_CLAIM
+                "mov %0, r0 \n" // assign r  =   r0
+              : "=r" (r)
+              : "I" (SYS_STDIO_CLAIM), "r" (x)
+              : "r0" );
+
+  return r;
+}
+
+FILE stdio_out = { STDOUT_FILENO, _IOLBF, { { 0 } } };
+FILE stdio_err = { STDERR_FILENO, _IONBF, { { 0 } } };
+
+FILE* stdout = &stdio_out;
+FILE* stderr = &stdio_err;
+
+// find, or claim, the buffer of the current process; return NULL if none
+stdio_buf_t* stdio_find(FILE* f) {
+  pid_t pid = get_self();
+
+  for (int i = 0; i < STDIO_PROCS; i++) {
+    if (f->bufs[i].pid == pid) {
+      return &f->bufs[i];
+    }
+  }
+
+  for (int i = 0; i < STDIO_PROCS; i++) {
+    if (f->bufs[i].pid == 0 && atomic_cas(&f->bufs[i].pid, 0, pid) == 0) {
+      f->bufs[i].n = 0;
+
+      // the kernel must know of the buffer to flush it if need be, so
+      // release it again (going unbuffered) if it cannot
+      if (_stdio_claim(&f->bufs[i]) < 0) {
+        f->bufs[i].pid = 0;
+        return NULL;
+      }
+
+      return &f->bufs[i];
+    }
+  }
+
+  return NULL;
+}
+
+void stdio_drain(FILE* f, stdio_buf_t* b) {
+  if (b->n > 0) {
+    write(f->fd, b->buf, b->n);
+    b->n = 0;
+  }
+}
+
+// flush, then release, the buffers of the current process
+void stdio_exit() {
+  FILE* fs[] = { stdout, stderr };
+  pid_t pid  = get_self();
+
+  for (int i = 0; i < 2; i++) {
+    for (int j = 0; j < STDIO_PROCS; j++) {
+      if (fs[i]->bufs[j].pid == pid) {
+        stdio_drain(fs[i], &fs[i]->bufs[j]);
+        fs[i]->bufs[j].pid = 0;
+      }
+    }
+  }
+}
+
+int  fputc(int c, FILE* f) {
+  stdio_buf_t* b = (f->mode == _IONBF) ? NULL : stdio_find(f);
+  char         x = c;
+
+  if (b == NULL) {
+    write(f->fd, &x, 1);
+    return c;
+  }
+
+  b->buf[b->n++] = x;
+
+  if (b->n == STDIO_BUF || (f->mode == _IOLBF && x == '\n')) {
+    stdio_drain(f, b);
+  }
+
+  return c;
+}
+
+int  fputs(const char* x, FILE* f) {
+  // unbuffered output still goes out in one system call
+  if (f->mode == _IONBF) {
+    write(f->fd, x, strlen(x));
+    return 0;
+  }
+
+  while (*x != '\x00') {
+    fputc(*x++, f);
+  }
+
+  return 0;
+}
+
+// write x padded to width w, on the left iff. l, with the character p
+int  stdio_pad(FILE* f, const char* x, int w, bool l, char p) {
+  int n = strlen(x), r = 0;
+
+  // pad zeros after any sign
+  if (p == '0' && *x == '-') {
+    fputc(*x++, f); n--; w--; r++;
+  }
+
+  for (; !l && w > n; w--, r++) {
+    fputc(p, f);
+  }
+  for (; *x != '\x00'; x++, r++) {
+    fputc(*x, f);
+  }
+  for (; l && w > n; w--, r++) {
+    fputc(' ', f);
+  }
+
+  return r;
+}
+
+void stdio_utoa(char* r, uint32_t x, int base, bool upper) {
+  const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+  char t[ 12 ]; int n = 0;
+
+  do {
+    t[n++] = digits[x % base]; x /= base;
+  } while (x);
+
+  while (n > 0) {
+    *r++ = t[--n];
+  }
+
+  *r = '\x00';
+}
+
+int  vfprintf(FILE* f, const char* x, va_list args) {
+  char t[ 12 ]; int r = 0;
+
+  for (; *x != '\x00'; x++) {
+    if (*x != '%') {
+      fputc(*x, f); r++;
+      continue;
+    }
+
+    bool l = false; char p = ' '; int w = 0;
+
+    for (x++; *x == '-' || *x == '0'; x++) {
+      if (*x == '-') l = true;
+      else           p = '0';
+    }
+    for (; *x >= '0' && *x <= '9'; x++) {
+      w = (w * 10) + (*x - '0');
+    }
+
+    switch (*x) {
+      case 'd' :
+      case 'i' : itoa(t, va_arg(args, int));                                break;
+      case 'u' : stdio_utoa(t, va_arg(args, uint32_t), 10, false);          break;
+      case 'x' : stdio_utoa(t, va_arg(args, uint32_t), 16, false);          break;
+      case 'X' : stdio_utoa(t, va_arg(args, uint32_t), 16,  true);          break;
+      case 'p' : stdio_utoa(t, (uint32_t) va_arg(args, void*), 16, false);  break;
+      case 'c' : t[0] = va_arg(args, int); t[1] = '\x00';                   break;
+      case 's' : r += stdio_pad(f, va_arg(args, char*), w, l, ' ');         continue;
+      case '%' : fputc('%', f); r++;                                        continue;
+      default  : x--;                                                       continue;
+    }
+
+    r += stdio_pad(f, t, w, l, p);
+  }
+
+  return r;
+}
+
+int  fprintf(FILE* f, const char* x, ...) {
+  va_list args; int r;
+
+  va_start(args, x);
+  r = vfprintf(f, x, args);
+  va_end(args);
+
+  return r;
+}
+
+int  printf(const char* x, ...) {
+  va_list args; int r;
+
+  va_start(args, x);
+  r = vfprintf(stdout, x, args);
+  va_end(args);
+
+  return r;
+}
+
+int  fflush(FILE* f) {
+  stdio_buf_t* b = stdio_find(f);
+
+  if (b != NULL) {
+    stdio_drain(f, b);
+  }
+
+  return 0;
+}
+
+int  setvbuf(FILE* f, char* x, int mode, size_t n) {
+  // the buffers are part of f, so any supplied are ignored
+  (void) x;
+  (void) n;
+
+  fflush(f);
+  f->mode = mode;
+
+  return 0;
+}
@@ -1,9 +1,11 @@
 #ifndef __LIBC_H
 #define __LIBC_H
 
+#include <stdarg.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 // Define a type that that captures a Process IDentifier (PID).
 
@@ -16,7 +18,8 @@ typedef int pid_t;
  * 2. signal identifiers (as used by the kill system call),
  * 3. status codes for exit,
  * 4. standard file descriptors (e.g., for read and write system calls),
- * 5. platform-specific constants, which may need calibration (wrt. the
+ * 5. performance counter events (as used by the pmu system calls),
+ * 6. platform-specific constants, which may need calibration (wrt. the
  *    underlying hardware QEMU is executed on).
  *
  * They don't *precisely* match the standard C library, but are intended
@@ -39,16 +42,284 @@ typedef int pid_t;
 
 #define SYS_ID         ( 0x11 )
 
+#define SYS_PMU_OPEN   ( 0x13 )
+#define SYS_PMU_READ   ( 0x14 )
+#define SYS_PMU_CLOSE  ( 0x15 )
+
+#define SYS_PROF_START ( 0x16 )
+#define SYS_PROF_STOP  ( 0x17 )
+#define SYS_PROF_DUMP  ( 0x18 )
+
+#define SYS_STATS      ( 0x19 )
+
+#define SYS_STACK_STAT ( 0x1A )
+
+#define SYS_KMEM_STAT  ( 0x1B )
+#define SYS_KMEM_LEAKS ( 0x1C )
+
+#define SYS_SCHED_RT   ( 0x1D )
+#define SYS_RT_MISSES  ( 0x1E )
+
+#define SYS_GROUP_NEW  ( 0x1F )
+#define SYS_GROUP_MOVE ( 0x20 )
+
+#define SYS_FUTEX_WAIT ( 0x21 )
+#define SYS_FUTEX_WAKE ( 0x22 )
+
+#define SYS_SHM_CREATE ( 0x23 )
+#define SYS_SHM_ATTACH ( 0x24 )
+#define SYS_SHM_DETACH ( 0x25 )
+
+#define SYS_POLL       ( 0x26 )
+
+#define SYS_CHAN_OPEN  ( 0x27 )
+#define SYS_CHAN_CLOSE ( 0x28 )
+#define SYS_CHAN_SUB   ( 0x29 )
+#define SYS_CHAN_PUB   ( 0x2A )
+#define SYS_CHAN_READ  ( 0x2B )
+
+#define SYS_SPAWN      ( 0x2C )
+
+#define SYS_THREAD_NEW  ( 0x2D )
+#define SYS_THREAD_JOIN ( 0x2E )
+
+#define SYS_URING_SETUP ( 0x2F )
+#define SYS_URING_ENTER ( 0x30 )
+
+#define SYS_FUTEX_WAIT_PI ( 0x31 )
+
+#define SYS_WAITPID    ( 0x32 )
+
+#define SYS_CLOCK_GETTIME ( 0x33 )
+
+#define SYS_STDIO_CLAIM ( 0x34 )
+
+#define SYS_SCHED_POLICY ( 0x35 )
+
 #define SIG_TERM      ( 0x00 )
 #define SIG_QUIT      ( 0x01 )
+#define SIG_ILL       ( 0x02 )
+#define SIG_SEGV      ( 0x03 )
 
 #define EXIT_SUCCESS  ( 0 )
 #define EXIT_FAILURE  ( 1 )
+#define EXIT_KILLED   ( 0x80 )
+
+#define WAIT_NOHANG   ( 0x1 )
+
+#define SCHED_PRIORITY ( 0 )
+#define SCHED_MLFQ     ( 1 )
 
 #define  STDIN_FILENO ( 0 )
 #define STDOUT_FILENO ( 1 )
 #define STDERR_FILENO ( 2 )
 
+#define PMU_EVENT_L1I_REFILL ( 0x01 )
+#define PMU_EVENT_L1D_REFILL ( 0x03 )
+#define PMU_EVENT_INSTR      ( 0x08 )
+#define PMU_EVENT_BR_MISPRED ( 0x10 )
+#define PMU_EVENT_CYCLES     ( 0xFF )
+
+/* Kernel statistics, as returned by the stats system call: the layout
+ * must match stats_t as declared in the kernel (see stats.h).
+ */
+
+#define STATS_IRQS    96
+#define STATS_SVCS    64
+#define STATS_BUCKETS 32
+
+typedef struct {
+  uint32_t uptime;                   // 100Hz ticks since reset
+  uint32_t clock;                    // clock ticks since reset
+  uint32_t irq[ STATS_IRQS ];        // interrupts    per GIC source
+  uint32_t svc[ STATS_SVCS ];        // system calls  per svc immediate
+  uint32_t switches;                 // context switches
+  uint32_t pipe_writes;              // pipe writes
+  uint32_t pipe_reads;               // pipe reads which returned data
+  uint32_t pipe_empty;               // pipe reads which found no data
+  uint32_t rt_misses;                // real-time deadline misses
+  uint32_t latency[ STATS_BUCKETS ]; // scheduling latency histogram
+} stats_t;
+
+// Stack usage, as returned by the stack_stat system call.
+
+typedef struct {
+  uint32_t size;                     // bytes allocated
+  uint32_t used;                     // bytes ever used, i.e., high-water mark
+  uint32_t overflow;                 // 1 iff. the guard word was overwritten
+} stack_stat_t;
+
+/* Kernel memory statistics, as returned by the kmem_stat system call:
+ * the layout must match kmem_stat_t as declared in the kernel (see
+ * kmem.h), as must the object types used to index it.
+ */
+
+#define KMEM_RING  0
+#define KMEM_NODE  1
+#define KMEM_CTX   2
+#define KMEM_PCB   3
+#define KMEM_PIPE  4
+
+#define KMEM_TYPES 5
+#define KMEM_SITES 16
+
+typedef struct {
+  uint32_t live;                     // bytes currently allocated
+  uint32_t peak;                     // maximum of live since reset
+  uint32_t allocs[ KMEM_TYPES ];     // allocations per type
+  uint32_t frees[ KMEM_TYPES ];      // frees       per type
+  uint32_t bytes[ KMEM_TYPES ];      // live bytes  per type
+  uint32_t site[ KMEM_SITES ];       // call site address
+  uint32_t site_bytes[ KMEM_SITES ]; // live bytes  per call site
+} kmem_stat_t;
+
+/* Descriptors waited on by poll, each either a pipe id or POLL_CONSOLE
+ * (i.e., the console UART): the layout must match pollfd_t as declared
+ * in the kernel (see poll.h).
+ */
+
+#define POLL_CONSOLE  ( 0 )
+
+#define POLL_IN       ( 0x01 )
+#define POLL_OUT      ( 0x02 )
+#define POLL_ERR      ( 0x04 )
+
+typedef struct {
+  int fd;                            // pipe id, or POLL_CONSOLE
+  int events;                        // POLL_IN and/or POLL_OUT
+  int revents;                       // events ready, or POLL_ERR
+} pollfd_t;
+
+/* The monotonic clock, read (bar for other clocks) without a system call
+ * from the clock page which the kernel keeps up to date: the layout must
+ * match clock_page_t as declared in the kernel (see clock.h).
+ */
+
+#define CLOCK_MONOTONIC ( 1 )
+
+typedef struct {
+  uint32_t           seq;           // odd iff. the page is being updated
+  uint32_t           hz;            // counter ticks per second
+  volatile uint32_t* counter;       // address of the down-counting counter
+  uint32_t           wraps;         // wraps of the counter up to last
+  uint32_t           last;          // (inverted) counter value at last update
+} clock_page_t;
+
+typedef struct {
+  uint32_t sec;
+  uint32_t nsec;
+} timespec_t;
+
+// Returned by the chan_read, thread_join and waitpid system calls iff.
+// there is nothing to read, or the thread or child has not exited, yet,
+// and by the poll system call iff. nothing is ready, yet.
+
+#define CHAN_AGAIN    ( -2 )
+#define THREAD_AGAIN  ( -2 )
+#define WAIT_AGAIN    ( -2 )
+#define POLL_AGAIN    ( -2 )
+
+/* Submission and completion rings, which batch system calls: queue any
+ * number of entries (via uring_get_sqe then uring_queue), then submit
+ * them all with one system call (or none, given URING_SQPOLL, as the
+ * kernel then consumes them at each timer tick, bar console and disk
+ * operations, for which uring_submit still makes one), and collect a result
+ * for each from the completion ring.  Operations never block, and the
+ * layout must match uring_t as declared in the kernel (see uring.h).
+ */
+
+#define URING_ENTRIES    32
+
+#define URING_SQPOLL     ( 0x01 )
+
+#define URING_NOP        ( 0 )       // result = 0
+#define URING_WRITE      ( 1 )       // write len bytes at addr to the console; result = len
+#define URING_PIPE_WRITE ( 2 )       // write addr into pipe fd; result = 0, or -1
+#define URING_PIPE_READ  ( 3 )       // read pipe fd; result = value, or -1
+#define URING_DISK_READ  ( 4 )       // read  len bytes at addr from disk block off
+#define URING_DISK_WRITE ( 5 )       // write len bytes at addr to   disk block off
+
+typedef struct {
+  uint32_t op;
+  int      fd;
+  uint32_t addr;
+  uint32_t len;
+  uint32_t off;
+  uint32_t user;                     // tag copied into the completion
+} uring_sqe_t;
+
+typedef struct {
+  uint32_t user;
+  int      res;
+} uring_cqe_t;
+
+typedef struct {
+  volatile uint32_t sq_head;
+  volatile uint32_t sq_tail;
+  volatile uint32_t cq_head;
+  volatile uint32_t cq_tail;
+  uint32_t          flags;
+  uring_sqe_t       sq[ URING_ENTRIES ];
+  uring_cqe_t       cq[ URING_ENTRIES ];
+} uring_t;
+
+/* Synchronisation primitives, shared between processes by virtue of the
+ * (single) address space: the uncontended paths are pure LDREX/STREX
+ * atomics, and only contended paths make futex_wait/futex_wake system
+ * calls, keyed by the address of the word contended for.  Each must be
+ * zero-initialised (i.e., a mutex is unlocked), other than a semaphore
+ * which is initialised via sem_init.
+ */
+
+#define MUTEX_WAITERS ( 0x80000000 )
+
+typedef struct {
+  volatile int value;                // 0 => unlocked, else holder pid (| MUTEX_WAITERS)
+} mutex_t;
+
+typedef struct {
+  volatile int value;                // count
+  volatile int waiters;              // processes blocked, or about to block
+} sem_t;
+
+typedef struct {
+  volatile int seq;                  // incremented by each signal or broadcast
+} cond_t;
+
+/* Buffered output: each FILE holds one buffer per process, found via the
+ * PID which the kernel leaves in TPIDRURO (so without a system call), st.
+ * output from different processes is never mixed within a buffer.  Each
+ * buffer is written by a single write system call once full, once it
+ * holds a newline (if line buffered, as stdout is by default), or once
+ * flushed, including by exit; stderr is unbuffered by default.  If more
+ * than STDIO_PROCS processes use a FILE at once, the rest go unbuffered.
+ * Each buffer claimed is registered with the kernel, which flushes then
+ * releases it if the process is killed: the layout of stdio_buf_t must
+ * match outbuf_t as declared in the kernel (see outbuf.h).
+ */
+
+#define STDIO_BUF     128
+#define STDIO_PROCS   16
+
+#define _IOFBF        ( 0 )
+#define _IOLBF        ( 1 )
+#define _IONBF        ( 2 )
+
+typedef struct {
+  volatile pid_t pid;                // owner (0 => unused)
+  int            n;                  // bytes buffered
+  char           buf[ STDIO_BUF ];
+} stdio_buf_t;
+
+typedef struct {
+  int            fd;
+  int            mode;               // _IOFBF, _IOLBF or _IONBF
+  stdio_buf_t    bufs[ STDIO_PROCS ];
+} FILE;
+
+extern FILE* stdout;
+extern FILE* stderr;
+
 // convert ASCII string x into integer r
 extern int  atoi(char* x);
 // convert integer x into ASCII string r
@@ -66,11 +337,30 @@ extern int  read(int fd, void* x,       size_t n);
 extern int  fork();
 // perform exit, i.e., terminate process with status x
 extern void exit(int x );
-// perform exec, i.e., start executing program at address x
-extern void exec(const void* x);
+// perform exec, i.e., start executing program at address x with an n-byte
+// stack (n = 0 => keep the current stack size)
+extern void exec(const void* x, size_t n);
 
-// signal process identified by pid with signal x
+// create count processes executing program at address x with given priority
+// and an n-byte stack (n = 0 => default size), i.e., fork plus exec without
+// copying the stack; the pids are consecutive, so return the first, or -1
+extern int  spawn(const void* x, int priority, size_t n, int count);
+
+// create a thread executing f(arg) with an n-byte stack (n = 0 => default
+// size), which shares everything else with the current process and exits
+// with the result of f; return its thread id (i.e., pid), or -1
+extern int  thread_create(int (*f)(void*), void* arg, size_t n);
+// wait for thread tid of the current process to exit, then copy its exit
+// status into x; return 0 iff. success
+extern int  thread_join(int tid, int* x);
+
+// signal process identified by pid with signal x, which terminates it with
+// status EXIT_KILLED | x; return 0 iff. success
 extern int  kill(pid_t pid, int x);
+// wait for child pid (pid < 0 => any child) to exit, then copy its exit status
+// into x (unless NULL); return its pid, 0 if flags has WAIT_NOHANG and none has
+// exited, or -1 if there is no such child
+extern int  waitpid(pid_t pid, int* x, int flags);
 
 // create pipe for IPC between processes pid1 and pid2
 extern int  open_pipe(pid_t pid1, pid_t pid2);
@@ -81,8 +371,146 @@ extern int  read_pipe(int id);
 // close pipe
 extern void close_pipe(int id);
 
+// read clock id into t; return 0 iff. success
+extern int  clock_gettime(int id, timespec_t* t);
+// read the monotonic clock in ticks since reset, i.e., the cheapest timestamp
+extern uint64_t clock_ticks();
+// the rate of clock_ticks, in ticks per second
+extern uint32_t clock_hz();
+
+// wait until any of the n descriptors fds is ready, or timeout ticks pass (< 0
+// => never, 0 => don't wait); return how many are ready, setting their revents
+extern int  poll(pollfd_t* fds, int n, int timeout);
+
+// open a broadcast channel; return its id, or -1
+extern int  chan_open();
+// close broadcast channel id; return 0 iff. success
+extern int  chan_close(int id);
+// subscribe to broadcast channel id, i.e., to messages published from now on;
+// return 0 iff. success
+extern int  chan_subscribe(int id);
+// publish x to every subscriber of channel id, without waiting for any; return
+// how many subscribers fell too far behind and lost a message, or -1
+extern int  chan_publish(int id, int x);
+// read the next message from channel id into x, blocking until there is one;
+// return how many messages were lost since the last read, or -1
+extern int  chan_read(int id, int* x);
+
+// register rings x with the kernel, given flags f (e.g., URING_SQPOLL); return 0
+extern int  uring_setup(uring_t* x, uint32_t f);
+// get the next free submission entry, or NULL if the ring is full
+extern uring_sqe_t* uring_get_sqe(uring_t* x);
+// queue the submission entry last got
+extern void uring_queue(uring_t* x);
+// have the kernel consume every queued entry (unless it polls, and every one
+// queued is a no-op or pipe entry); return how many
+extern int  uring_submit(uring_t* x);
+// get the next completion entry, or NULL if there is none
+extern uring_cqe_t* uring_peek_cqe(uring_t* x);
+// get the next completion entry, blocking until there is one
+extern uring_cqe_t* uring_wait_cqe(uring_t* x);
+// release the completion entry last got
+extern void uring_cqe_seen(uring_t* x);
+
 // get pid for current process
 int get_proc_id();
+// get pid for current process without a system call
+extern pid_t get_self();
+
+// write character c to f; return c
+extern int  fputc(int c, FILE* f);
+// write string x to f; return 0
+extern int  fputs(const char* x, FILE* f);
+// write string x formatted per %d, %i, %u, %x, %X, %p, %c, %s and %% (each
+// with optional '-' or '0' flag and width) to f; return bytes written
+extern int  vfprintf(FILE* f, const char* x, va_list args);
+extern int  fprintf(FILE* f, const char* x, ...);
+extern int  printf(const char* x, ...);
+// write whatever the current process has buffered for f; return 0
+extern int  fflush(FILE* f);
+// select buffering mode (x and n are ignored: buffers are STDIO_BUF bytes)
+extern int  setvbuf(FILE* f, char* x, int mode, size_t n);
+
+// start counting event x for process pid (0 => current); return 0 iff. success
+extern int      pmu_open(pid_t pid, int x);
+// read  count of event x for process pid (0 => current)
+extern uint32_t pmu_read(pid_t pid, int x);
+// stop  counting event x for process pid (0 => current)
+extern void     pmu_close(pid_t pid, int x);
+
+// start sampling PCs every x profiling timer ticks, clearing the histogram
+extern void prof_start(uint32_t x);
+// stop  sampling PCs
+extern void prof_stop();
+// dump  the PC histogram to the kernel UART
+extern void prof_dump();
+
+// copy kernel statistics into x
+extern void stats(stats_t* x);
+
+// get stack size, high-water mark and overflow flag of process pid (0 => current)
+extern int  stack_stat(pid_t pid, stack_stat_t* x);
+
+// copy kernel memory statistics into x
+extern void kmem_stat(kmem_stat_t* x);
+// dump leaked kernel objects to the kernel UART; return how many there are
+extern int  kmem_leaks();
+
+// become real-time: every period ticks, run for budget ticks within deadline
+// ticks (0 => period); return 0 iff. admitted
+extern int  sched_rt(uint32_t period, uint32_t budget, uint32_t deadline);
+// get number of deadline misses of process pid (0 => current)
+extern int  rt_misses(pid_t pid);
+// switch the scheduling policy to x (e.g., SCHED_MLFQ); return 0 iff. success
+extern int  sched_policy(int x);
+
+// create process group limited to quota ticks per period ticks; return its id
+extern int  group_create(uint32_t quota, uint32_t period);
+// move process pid (0 => current) into group id; return 0 iff. success
+extern int  group_move(pid_t pid, int id);
+
+// create a zeroed shared memory segment of (at least) n bytes, attached to the
+// caller; return its id, or -1
+extern int   shm_create(size_t n);
+// attach to shared memory segment id; return its address, or NULL
+extern void* shm_attach(int id);
+// detach from shared memory segment id, which is freed once nobody is attached
+// (exit detaches from every segment); return 0 iff. success
+extern int   shm_detach(int id);
+
+// atomically set *x = y iff. *x == c; return the original *x
+extern int  atomic_cas(volatile int* x, int c, int y);
+// atomically set *x = y; return the original *x
+extern int  atomic_swap(volatile int* x, int y);
+// atomically set *x = *x + y; return the original *x
+extern int  atomic_add(volatile int* x, int y);
+
+// block until woken via address x, iff. *x == v on entry; return 0 iff. woken
+extern int  futex_wait(volatile int* x, int v);
+// as futex_wait, but *x holds the pid of a lock holder (| MUTEX_WAITERS), which
+// inherits the priority of the caller while it is blocked
+extern int  futex_wait_pi(volatile int* x, int v);
+// wake up to n processes blocked on address x; return how many were woken
+extern int  futex_wake(volatile int* x, int n);
+
+// acquire and release mutex x
+extern void mutex_lock(mutex_t* x);
+extern void mutex_unlock(mutex_t* x);
+// acquire mutex x iff. it is unlocked; return true iff. acquired
+extern bool mutex_trylock(mutex_t* x);
+
+// initialise semaphore x with count n
+extern void sem_init(sem_t* x, int n);
+// decrement semaphore x, blocking while the count is 0
+extern void sem_wait(sem_t* x);
+// increment semaphore x, waking a blocked process if any
+extern void sem_post(sem_t* x);
+
+// release mutex m, block until condition x is signalled, then reacquire m
+extern void cond_wait(cond_t* x, mutex_t* m);
+// wake one or every process waiting on condition x
+extern void cond_signal(cond_t* x);
+extern void cond_broadcast(cond_t* x);
 
 int  _read_pipe(int id);
 
@@ -90,4 +518,22 @@ int  _check_pipe(int id, int c_val);
 
 void _write_pipe(int id, int x);
 
+int  _chan_read(int id, int* x);
+
+void _thread_start(int (*f)(void*), void* arg);
+
+void stdio_exit();
+
+int  _thread_join(int tid, int* x);
+
+int  _waitpid(pid_t pid, int* x, int flags);
+
+int  _clock_gettime(int id, timespec_t* t);
+
+int  _poll(pollfd_t* fds, int n, int timeout);
+
+int  _stdio_claim(stdio_buf_t* x);
+
+bool _uring_pollable(uring_t* x);
+
 #endif
@@ -5,20 +5,26 @@ void main_philosopher() {
   // assume console is 1st prog, waiter is 2nd
   int philosopher_id = current_pid - 3;
 
-  int can_eat;
+  int left  = philosopher_id;
+  int right = (philosopher_id + 1) % PHILOSOPHER_NUM;
+
   while (1) {
-    can_eat = read_pipe(philosopher_id);
-
-    char phil_id_str[2];
-    itoa(phil_id_str, philosopher_id + 1);
-    write(STDOUT_FILENO, phil_id_str, 2);
-
-    if (can_eat) {
-      write(STDOUT_FILENO, ": eating  \n", 12);
-    }
-    else {
-      write(STDOUT_FILENO, ": thinking\n", 12);
-    }
+    sem_wait(&seats);
+    mutex_lock(&forks[left]);
+    mutex_lock(&forks[right]);
+
+    printf("%d: eating\n", philosopher_id + 1);
+
+    mutex_lock(&table);
+    meals++;
+    cond_signal(&served);
+    mutex_unlock(&table);
+
+    mutex_unlock(&forks[right]);
+    mutex_unlock(&forks[left]);
+    sem_post(&seats);
+
+    printf("%d: thinking\n", philosopher_id + 1);
   }
 
   exit( EXIT_SUCCESS );
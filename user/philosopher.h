@@ -1,10 +1,11 @@
-#ifndef __WAITER_H
-#define __WAITER_H
+#ifndef __PHILOSOPHER_H
+#define __PHILOSOPHER_H
 
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
 #include "libc.h"
+#include "waiter.h"
 
 #endif
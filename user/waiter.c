@@ -1,32 +1,35 @@
 #include "waiter.h"
 
-int philosopher_pipe_ids[PHILOSOPHER_NUM];
-int philosopher_pids[PHILOSOPHER_NUM];
+/* The waiter seats at most PHILOSOPHER_NUM - 1 philosophers at once, so
+ * at least one seated philosopher can always pick up both forks, i.e.,
+ * there is no deadlock.  Each fork is a mutex, the seats a semaphore,
+ * and the waiter sleeps on a condition variable until meals are served.
+ */
+
+mutex_t forks[PHILOSOPHER_NUM];
+sem_t   seats;
+mutex_t table;
+cond_t  served;
+int     meals;
 
 extern void main_philosopher();
 
 void main_waiter() {
-  pid_t proc_id = get_proc_id();
+  sem_init(&seats, PHILOSOPHER_NUM - 1);
 
-  // loop over fork to create correct number of child processes
-  for (int i = 0; i < PHILOSOPHER_NUM; i++) {
-    philosopher_pids[i] = fork(10);
+  // create every philosopher at once, with consecutive pids
+  spawn(&main_philosopher, 10, 0x1000, PHILOSOPHER_NUM);
 
-    philosopher_pipe_ids[i] = open_pipe(proc_id, philosopher_pids[i]);
-
-    if (philosopher_pids[i] == 0) {
-      exec(&main_philosopher);
-    }
-  }
-
-  // one philosopher eats, the rest think
-  int eating_philosopher = 0;
+  int reported = 0;
   while (1) {
-    for (int i = 0; i < PHILOSOPHER_NUM; i++) {
-      if (i == eating_philosopher) write_pipe(i, 1);
-      else                         write_pipe(i, 0);
+    mutex_lock(&table);
+    while (meals - reported < WAITER_REPORT) {
+      cond_wait(&served, &table);
     }
-    eating_philosopher = (eating_philosopher + 1) % PHILOSOPHER_NUM;
+    reported = meals;
+    mutex_unlock(&table);
+
+    printf("meals: %d\n", reported);
   }
 
   exit( EXIT_SUCCESS );
@@ -4,9 +4,20 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "libc.h"
 
 #define PHILOSOPHER_NUM 4
 
+// report the number of meals served every so many meals
+#define WAITER_REPORT   64
+
+// the table, shared by the waiter and every philosopher
+extern mutex_t forks[PHILOSOPHER_NUM];
+extern sem_t   seats;
+extern mutex_t table;
+extern cond_t  served;
+extern int     meals;
+
 #endif